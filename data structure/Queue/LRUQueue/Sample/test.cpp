@@ -77,5 +77,12 @@ int main()
 
 	cout << std::boolalpha \
 		<< cache.empty() << endl;
+
+#ifdef ETERFREE_LRU_STATISTICS
+	const auto& statistics = cache.statistics();
+	cout << statistics._hits << ' ' << statistics._misses << ' ' \
+		<< statistics._inserts << ' ' << statistics._evictions << endl;
+	cout << statistics._push.percentile(0.99).count() << "ns" << endl;
+#endif
 	return EXIT_SUCCESS;
 }
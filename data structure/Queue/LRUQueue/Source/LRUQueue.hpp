@@ -3,6 +3,10 @@
 #include "Common.hpp"
 #include "Version.hpp"
 
+#ifdef ETERFREE_LRU_STATISTICS
+#include "Statistics.hpp"
+#endif
+
 #include <utility>
 #include <list>
 #include <unordered_map>
@@ -35,6 +39,10 @@ private:
 	QueueType _queue; // pair(key, value)
 	TableType _table; // key -> iterator(_queue)
 
+#ifdef ETERFREE_LRU_STATISTICS
+	LRUStatistics _statistics;
+#endif
+
 private:
 	void move(Iterator& _iterator);
 
@@ -74,6 +82,19 @@ public:
 	NODISCARD bool pop(QueueType& _queue);
 
 	void clear() noexcept;
+
+#ifdef ETERFREE_LRU_STATISTICS
+	// 获取统计数据，定义宏ETERFREE_LRU_STATISTICS以启用
+	NODISCARD const LRUStatistics& statistics() const noexcept
+	{
+		return _statistics;
+	}
+
+	void resetStatistics() noexcept
+	{
+		_statistics.reset();
+	}
+#endif
 };
 
 template <typename _KeyType, typename _ValueType>
@@ -94,6 +115,10 @@ void LRUQueue<_KeyType, _ValueType>::erase()
 		auto iterator = _queue.cbegin();
 		_table.erase(iterator->first);
 		_queue.erase(iterator);
+
+#ifdef ETERFREE_LRU_STATISTICS
+		++_statistics._evictions;
+#endif
 	}
 }
 
@@ -101,8 +126,22 @@ template <typename _KeyType, typename _ValueType>
 auto LRUQueue<_KeyType, _ValueType>::find(const KeyType& _key) \
 -> const ValueType*
 {
+#ifdef ETERFREE_LRU_STATISTICS
+	LatencyHistogram::Sampler sampler(_statistics._find);
+#endif
+
 	auto iterTable = _table.find(_key);
-	if (iterTable == _table.end()) return nullptr;
+	if (iterTable == _table.end())
+	{
+#ifdef ETERFREE_LRU_STATISTICS
+		++_statistics._misses;
+#endif
+		return nullptr;
+	}
+
+#ifdef ETERFREE_LRU_STATISTICS
+	++_statistics._hits;
+#endif
 
 	auto& iterQueue = iterTable->second;
 	auto& value = iterQueue->second;
@@ -115,9 +154,17 @@ template <typename _KeyType, typename _ValueType>
 void LRUQueue<_KeyType, _ValueType>::push(const KeyType& _key, \
 	const ValueType& _value)
 {
+#ifdef ETERFREE_LRU_STATISTICS
+	LatencyHistogram::Sampler sampler(_statistics._push);
+#endif
+
 	auto iterTable = _table.find(_key);
 	if (iterTable == _table.end())
 	{
+#ifdef ETERFREE_LRU_STATISTICS
+		++_statistics._inserts;
+#endif
+
 		erase();
 
 		auto iterQueue = _queue.emplace(_queue.end(), \
@@ -126,6 +173,10 @@ void LRUQueue<_KeyType, _ValueType>::push(const KeyType& _key, \
 	}
 	else
 	{
+#ifdef ETERFREE_LRU_STATISTICS
+		++_statistics._updates;
+#endif
+
 		auto& iterQueue = iterTable->second;
 		iterQueue->second = _value;
 
@@ -137,9 +188,17 @@ template <typename _KeyType, typename _ValueType>
 void LRUQueue<_KeyType, _ValueType>::push(const KeyType& _key, \
 	ValueType&& _value)
 {
+#ifdef ETERFREE_LRU_STATISTICS
+	LatencyHistogram::Sampler sampler(_statistics._push);
+#endif
+
 	auto iterTable = _table.find(_key);
 	if (iterTable == _table.end())
 	{
+#ifdef ETERFREE_LRU_STATISTICS
+		++_statistics._inserts;
+#endif
+
 		erase();
 
 		auto iterQueue = _queue.emplace(_queue.end(), \
@@ -148,6 +207,10 @@ void LRUQueue<_KeyType, _ValueType>::push(const KeyType& _key, \
 	}
 	else
 	{
+#ifdef ETERFREE_LRU_STATISTICS
+		++_statistics._updates;
+#endif
+
 		auto& iterQueue = iterTable->second;
 		iterQueue->second = std::forward<ValueType>(_value);
 
@@ -0,0 +1,171 @@
+﻿#pragma once
+
+#include "Common.hpp"
+#include "Version.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <chrono>
+
+// 采样周期，须为二的幂，每周期采样一次耗时
+#ifndef ETERFREE_LRU_SAMPLE_PERIOD
+#define ETERFREE_LRU_SAMPLE_PERIOD 64
+#endif
+
+/*
+ * 耗时直方图
+ * 按照纳秒数的二进制位数分桶，第零桶记录零纳秒，第i桶记录[2^(i-1), 2^i)纳秒。
+ */
+class LatencyHistogram final
+{
+public:
+	using SizeType = std::uint_least64_t;
+	using Duration = std::chrono::nanoseconds;
+
+	class Sampler;
+
+private:
+	static constexpr std::size_t BUCKETS = 64;
+	static constexpr SizeType PERIOD = ETERFREE_LRU_SAMPLE_PERIOD;
+
+	static_assert(PERIOD > 0 && (PERIOD & (PERIOD - 1)) == 0, \
+		"The sample period must be a power of two.");
+
+private:
+	SizeType _counter; // 调用次数，用于采样
+	SizeType _count; // 样本数量
+	SizeType _sum;
+	SizeType _max;
+	std::array<SizeType, BUCKETS> _buckets;
+
+private:
+	static std::size_t index(SizeType _duration) noexcept
+	{
+		std::size_t index = 0;
+		for (; _duration > 0 && index + 1 < BUCKETS; _duration >>= 1)
+			++index;
+		return index;
+	}
+
+public:
+	LatencyHistogram() noexcept { reset(); }
+
+	// 是否采样本次调用
+	NODISCARD bool sample() noexcept
+	{
+		return (_counter++ & (PERIOD - 1)) == 0;
+	}
+
+	void record(Duration _duration) noexcept;
+
+	NODISCARD SizeType count() const noexcept { return _count; }
+
+	NODISCARD Duration max() const noexcept { return Duration(_max); }
+
+	NODISCARD Duration mean() const noexcept
+	{
+		return Duration(_count > 0 ? _sum / _count : 0);
+	}
+
+	/*
+	 * 获取指定百分位的耗时上限
+	 * 参数取值范围为[0, 1]，返回所在桶的上界。
+	 */
+	NODISCARD Duration percentile(double _ratio) const noexcept;
+
+	void reset() noexcept
+	{
+		_counter = _count = _sum = _max = 0;
+		_buckets.fill(0);
+	}
+};
+
+// 采样器：构造时决定是否采样，析构时记录耗时
+class LatencyHistogram::Sampler final
+{
+	using Clock = std::chrono::steady_clock;
+
+private:
+	LatencyHistogram* _histogram;
+	Clock::time_point _timePoint;
+
+public:
+	explicit Sampler(LatencyHistogram& _histogram) noexcept : \
+		_histogram(_histogram.sample() ? &_histogram : nullptr)
+	{
+		if (this->_histogram != nullptr)
+			_timePoint = Clock::now();
+	}
+
+	Sampler(const Sampler&) = delete;
+
+	~Sampler()
+	{
+		if (_histogram != nullptr)
+			_histogram->record(std::chrono::duration_cast<Duration>(Clock::now() - _timePoint));
+	}
+
+	Sampler& operator=(const Sampler&) = delete;
+};
+
+inline void LatencyHistogram::record(Duration _duration) noexcept
+{
+	auto duration = static_cast<SizeType>(_duration.count() > 0 ? _duration.count() : 0);
+	++_buckets[index(duration)];
+	++_count;
+	_sum += duration;
+	if (duration > _max) _max = duration;
+}
+
+inline auto LatencyHistogram::percentile(double _ratio) const noexcept \
+-> Duration
+{
+	if (_count <= 0) return Duration::zero();
+
+	auto target = static_cast<SizeType>(_ratio * _count);
+	if (target <= 0) target = 1;
+	else if (target > _count) target = _count;
+
+	SizeType count = 0;
+	for (std::size_t index = 0; index < BUCKETS; ++index)
+	{
+		count += _buckets[index];
+		if (count >= target)
+			return Duration(index > 0 ? SizeType(1) << index : 0);
+	}
+	return max();
+}
+
+// LRU队列统计数据
+struct LRUStatistics final
+{
+	using SizeType = LatencyHistogram::SizeType;
+
+	SizeType _hits; // 查找命中次数
+	SizeType _misses; // 查找未命中次数
+	SizeType _inserts; // 放入新元素次数
+	SizeType _updates; // 放入已有元素次数
+	SizeType _evictions; // 超出容量淘汰次数
+
+	LatencyHistogram _find; // 查找耗时
+	LatencyHistogram _push; // 放入耗时
+
+	LRUStatistics() noexcept : \
+		_hits(0), _misses(0), _inserts(0), \
+		_updates(0), _evictions(0) {}
+
+	// 命中率
+	NODISCARD double hitRatio() const noexcept
+	{
+		auto total = _hits + _misses;
+		return total > 0 ? static_cast<double>(_hits) / total : 0.0;
+	}
+
+	void reset() noexcept
+	{
+		_hits = _misses = _inserts = _updates = _evictions = 0;
+		_find.reset();
+		_push.reset();
+	}
+};
@@ -1,11 +1,104 @@
 ﻿#include "TimeoutQueue.hpp"
+#include "TimingWheel.hpp"
+#include "TimerService.hpp"
 
 #include <cstdlib>
 #include <type_traits>
 #include <ctime>
 #include <chrono>
 #include <iostream>
+#include <mutex>
+#include <stdexcept>
 #include <thread>
+#include <vector>
+
+/*
+ * 先放入较远的超时时间，再放入大量较近的超时时间
+ * 较近的元素应当位于时间轮之中，而非滞留于到期槽，逐刻取出的总耗时与元素数量成线性关系。
+ */
+static bool testTimingWheel()
+{
+	constexpr int NUMBER = 100000;
+	using WheelType = TimingWheel<long long, int>;
+
+	WheelType wheel;
+	wheel.push(NUMBER * 2LL, 0);
+	for (int index = 1; index <= NUMBER; ++index)
+		wheel.push(index, index);
+
+	auto begin = std::chrono::steady_clock::now();
+
+	WheelType::Vector vector;
+	for (long long time = 1; time <= NUMBER; ++time)
+	{
+		vector.clear();
+		if (not wheel.pop(time, vector) \
+			or vector.size() != 1 or vector.front() != time)
+			return false;
+	}
+
+	auto duration = std::chrono::duration_cast<std::chrono::milliseconds>( \
+		std::chrono::steady_clock::now() - begin);
+	std::cout << "timing wheel: " << duration.count() << "ms" << std::endl;
+
+	vector.clear();
+	return wheel.size() == 1 and wheel.pop(NUMBER * 2LL, vector) \
+		and vector.front() == 0 and wheel.empty();
+}
+
+/*
+ * 先放入较晚的定时器，再放入与提前较早的定时器，后台线程应当提前唤醒，按照时间顺序分批回调
+ * 回调元素1之时抛出异常，由服务记录；回调元素9之时于回调之中停止服务，之后的定时器保留于队列。
+ */
+static bool testTimerService()
+{
+	using namespace std::chrono_literals;
+	using ServiceType = TimerService<int>;
+
+	std::mutex mutex;
+	std::vector<int> sequence;
+	bool batched = true;
+
+	ServiceType* pointer = nullptr;
+	ServiceType service([&](ServiceType::Vector& _vector)
+		{
+			bool thrown = false, stopped = false;
+			{
+				std::lock_guard lock(mutex);
+				batched = batched and _vector.size() <= 2;
+				for (auto element : _vector)
+				{
+					sequence.push_back(element);
+					thrown = thrown or element == 1;
+					stopped = stopped or element == 9;
+				}
+			}
+
+			if (stopped) pointer->stop();
+			if (thrown) throw std::runtime_error("timer callback");
+		}, 0, 2);
+	pointer = &service;
+
+	service.push(200ms, 2);
+	service.push(50ms, 1);
+	for (int element = 3; element <= 5; ++element)
+		service.push(100ms, element);
+	service.push(1s, 6);
+	service.reschedule(6, 150ms);
+	service.push(250ms, 9);
+	service.push(400ms, 10);
+
+	std::this_thread::sleep_for(600ms);
+
+	std::lock_guard lock(mutex);
+	for (auto element : sequence)
+		std::cout << element << ' ';
+	std::cout << std::endl;
+
+	return sequence == std::vector<int>{ 1, 3, 4, 5, 6, 2, 9 } \
+		and batched and service.exception() != nullptr \
+		and service.size() == 1 and service.exist(10);
+}
 
 int main()
 {
@@ -40,5 +133,8 @@ int main()
 
 	cout << std::boolalpha \
 		<< queue.empty() << endl;
+
+	cout << testTimingWheel() << endl;
+	cout << testTimerService() << endl;
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,325 @@
+﻿#pragma once
+
+#include <concepts>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <chrono>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * 时间粒度
+ * 将时间因子向上取整至分辨率的整数倍，支持整数与std::chrono::time_point。
+ */
+template <typename _TimeType>
+struct TimeGranularity
+{
+	using Duration = _TimeType;
+
+	static _TimeType ceil(_TimeType _time, Duration _resolution) noexcept
+	{
+		auto quotient = _time / _resolution;
+		if (quotient * _resolution < _time) ++quotient;
+		return quotient * _resolution;
+	}
+};
+
+template <typename _Clock, typename _Duration>
+struct TimeGranularity<std::chrono::time_point<_Clock, _Duration>>
+{
+	using TimeType = std::chrono::time_point<_Clock, _Duration>;
+	using Duration = _Duration;
+
+	static TimeType ceil(TimeType _time, Duration _resolution) noexcept
+	{
+		auto count = TimeGranularity<typename Duration::rep>::ceil(_time.time_since_epoch().count(), \
+			_resolution.count());
+		return TimeType(Duration(count));
+	}
+};
+
+/*
+ * 粗粒度超时队列
+ * 接口与超时队列一致，超时时间向上取整至分辨率的整数倍，同一时间桶的元素存储于连续数组，
+ * 超时元素按桶整体取出，因此元素至多延迟一个分辨率超时，而不会提前超时。
+ * 索引表默认为无序映射，元素须支持std::hash，记录元素所在的时间桶与下标，弹出指定元素无需遍历。
+ */
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType = std::unordered_map>
+class CoarseTimeoutQueue final
+{
+public:
+	using TimeType = _TimeType;
+	using Element = _Element;
+
+	using Duration = TimeGranularity<TimeType>::Duration;
+
+	using Vector = std::vector<Element>;
+	using SizeType = Vector::size_type;
+
+private:
+	using QueueType = std::map<TimeType, Vector>;
+	using Iterator = QueueType::iterator;
+
+	struct Index
+	{
+		Iterator _bucket;
+		SizeType _index;
+	};
+
+	using TableType = _TableType<Element, Index>;
+
+private:
+	SizeType _capacity;
+	Duration _resolution;
+	QueueType _queue;
+	TableType _table;
+
+private:
+	// 放入指定时间桶，返回索引
+	Index insert(TimeType _time, const Element& _element);
+
+	// 从所在时间桶删除元素，以桶尾元素填补空位，不修改元素自身的索引
+	void erase(const Index& _index);
+
+	/*
+	 * 依次取出超时元素，转交指定函数处理，返回取出数量
+	 * 倘若指定数量为零，取出所有超时元素，否则至多取出指定数量的元素。
+	 */
+	template <typename _Function>
+	SizeType expire(TimeType _time, _Function&& _function, SizeType _size);
+
+public:
+	explicit CoarseTimeoutQueue(Duration _resolution, \
+		SizeType _capacity = 0) : \
+		_capacity(_capacity), _resolution(_resolution) {}
+
+	auto capacity() const noexcept { return _capacity; }
+	void reserve(decltype(_capacity) _capacity) noexcept
+	{
+		this->_capacity = _capacity;
+	}
+
+	auto resolution() const noexcept { return _resolution; }
+
+	bool empty() const noexcept { return _table.empty(); }
+	auto size() const noexcept { return _table.size(); }
+
+	bool exist(const Element& _element) const
+	{
+		return _table.contains(_element);
+	}
+
+	// 获取队首时间桶的时间，若队列为空则返回空值
+	std::optional<TimeType> front() const
+	{
+		if (_queue.empty()) return std::nullopt;
+		return _queue.cbegin()->first;
+	}
+
+	bool push(TimeType _time, const Element& _element);
+
+	/*
+	 * 重新设置指定元素的超时时间，若无指定元素则返回false
+	 * 新旧时间位于同一时间桶则无需调整。
+	 */
+	bool reschedule(const Element& _element, TimeType _time);
+
+	bool pop(const Element& _element);
+
+	/*
+	 * 取出超时元素，追加至向量
+	 * 倘若指定数量为零，取出所有超时元素，否则至多取出指定数量的元素，以限制单次耗时。
+	 */
+	bool pop(TimeType _time, Vector& _vector, SizeType _size = 0);
+
+	// 取出超时元素，转交回调函数处理，返回取出数量
+	template <typename _Function>
+		requires std::invocable<_Function&, Element&&>
+	SizeType pop(TimeType _time, _Function _function, SizeType _size = 0)
+	{
+		return expire(_time, _function, _size);
+	}
+
+	// 取出超时元素，写入输出迭代器，返回写入之后的迭代器
+	template <typename _Iterator>
+		requires std::output_iterator<_Iterator, Element&&>
+	_Iterator pop(TimeType _time, _Iterator _iterator, SizeType _size = 0)
+	{
+		expire(_time, [&_iterator](Element&& _element)
+			{
+				*_iterator++ = std::move(_element);
+			}, _size);
+		return _iterator;
+	}
+
+	bool pop(Vector& _vector);
+
+	void clear() noexcept
+	{
+		_queue.clear();
+		_table.clear();
+	}
+};
+
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType>
+auto CoarseTimeoutQueue<_TimeType, _Element, _TableType>::insert(TimeType _time, \
+	const Element& _element) -> Index
+{
+	auto time = TimeGranularity<TimeType>::ceil(_time, _resolution);
+	auto bucket = _queue.try_emplace(time).first;
+
+	auto& vector = bucket->second;
+	try
+	{
+		vector.push_back(_element);
+	}
+	catch (...)
+	{
+		if (vector.empty()) _queue.erase(bucket);
+		throw;
+	}
+	return Index{ bucket, vector.size() - 1 };
+}
+
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType>
+void CoarseTimeoutQueue<_TimeType, _Element, _TableType>::erase(const Index& _index)
+{
+	auto bucket = _index._bucket;
+	auto& vector = bucket->second;
+
+	if (auto last = vector.size() - 1; _index._index < last)
+	{
+		auto& element = vector[_index._index];
+		element = std::move(vector[last]);
+		_table.find(element)->second._index = _index._index;
+	}
+
+	vector.pop_back();
+	if (vector.empty()) _queue.erase(bucket);
+}
+
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType>
+template <typename _Function>
+auto CoarseTimeoutQueue<_TimeType, _Element, _TableType>::expire(TimeType _time, \
+	_Function&& _function, SizeType _size) -> SizeType
+{
+	SizeType count = 0;
+	while (not _queue.empty() and (_size <= 0 or count < _size))
+	{
+		auto bucket = _queue.begin();
+		if (_time < bucket->first) break;
+
+		// 自桶尾取出，其余元素的下标保持不变
+		auto& vector = bucket->second;
+		while (not vector.empty() and (_size <= 0 or count < _size))
+		{
+			auto position = _table.find(vector.back());
+			_function(std::move(vector.back()));
+			_table.erase(position);
+			vector.pop_back();
+			++count;
+		}
+
+		if (vector.empty()) _queue.erase(bucket);
+	}
+	return count;
+}
+
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType>
+bool CoarseTimeoutQueue<_TimeType, _Element, _TableType>::push(TimeType _time, \
+	const Element& _element)
+{
+	if (_capacity > 0 and size() >= _capacity) return false;
+	if (exist(_element)) return false;
+
+	auto index = insert(_time, _element);
+	try
+	{
+		_table.emplace(_element, index);
+	}
+	catch (...)
+	{
+		auto& vector = index._bucket->second;
+		vector.pop_back();
+		if (vector.empty()) _queue.erase(index._bucket);
+		throw;
+	}
+	return true;
+}
+
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType>
+bool CoarseTimeoutQueue<_TimeType, _Element, _TableType>::reschedule(const Element& _element, \
+	TimeType _time)
+{
+	auto iterator = _table.find(_element);
+	if (iterator == _table.end()) return false;
+
+	auto time = TimeGranularity<TimeType>::ceil(_time, _resolution);
+	if (iterator->second._bucket->first == time) return true;
+
+	auto index = iterator->second;
+	iterator->second = insert(time, _element);
+	erase(index);
+	return true;
+}
+
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType>
+bool CoarseTimeoutQueue<_TimeType, _Element, _TableType>::pop(const Element& _element)
+{
+	auto iterator = _table.find(_element);
+	if (iterator == _table.end()) return false;
+
+	auto index = iterator->second;
+	_table.erase(iterator);
+	erase(index);
+	return true;
+}
+
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType>
+bool CoarseTimeoutQueue<_TimeType, _Element, _TableType>::pop(TimeType _time, \
+	Vector& _vector, SizeType _size)
+{
+	auto result = false;
+
+	// 向量为空且不限数量之时，直接交换整个时间桶
+	if (_size <= 0 and _vector.empty() and not _queue.empty())
+		if (auto bucket = _queue.begin(); not (_time < bucket->first))
+		{
+			_vector.swap(bucket->second);
+			_queue.erase(bucket);
+
+			for (const auto& element : _vector)
+				_table.erase(element);
+			result = true;
+		}
+
+	return expire(_time, [&_vector](Element&& _element)
+		{
+			_vector.push_back(std::move(_element));
+		}, _size) > 0 or result;
+}
+
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType>
+bool CoarseTimeoutQueue<_TimeType, _Element, _TableType>::pop(Vector& _vector)
+{
+	if (empty()) return false;
+
+	_vector.reserve(_vector.size() + size());
+	for (auto& [_, vector] : _queue)
+		for (auto& element : vector)
+			_vector.push_back(std::move(element));
+
+	clear();
+	return true;
+}
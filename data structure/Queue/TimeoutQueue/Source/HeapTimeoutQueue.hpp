@@ -0,0 +1,233 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * 多叉堆超时队列
+ * 接口与超时队列一致，以连续数组存储多叉堆，堆节点仅含时间因子与索引表项的指针。
+ * 索引表默认为无序映射，元素须支持std::hash；索引表项记录堆节点下标，弹出指定元素无需查找。
+ */
+template <typename _TimeType, typename _Element, std::size_t _ARITY = 4, \
+	template <typename, typename, typename...> class _TableType = std::unordered_map>
+class HeapTimeoutQueue final
+{
+	static_assert(_ARITY >= 2, "The arity of a heap must be at least two.");
+
+public:
+	using TimeType = _TimeType;
+	using Element = _Element;
+
+	using Vector = std::vector<Element>;
+	using SizeType = Vector::size_type;
+
+private:
+	using TableType = _TableType<Element, SizeType>; // element -> index(_heap)
+	using PairType = TableType::value_type;
+
+	struct Entry
+	{
+		TimeType _time;
+		PairType* _pair;
+	};
+
+	using HeapType = std::vector<Entry>;
+
+private:
+	SizeType _capacity;
+	HeapType _heap;
+	TableType _table;
+
+private:
+	void place(SizeType _index, Entry&& _entry) noexcept
+	{
+		_entry._pair->second = _index;
+		_heap[_index] = std::move(_entry);
+	}
+
+	void up(SizeType _index) noexcept;
+	void down(SizeType _index) noexcept;
+
+	// 删除指定下标的堆节点，不修改索引表
+	void erase(SizeType _index) noexcept;
+
+public:
+	HeapTimeoutQueue(decltype(_capacity) _capacity = 0) : \
+		_capacity(_capacity) {}
+
+	auto capacity() const noexcept { return _capacity; }
+	void reserve(decltype(_capacity) _capacity) noexcept
+	{
+		this->_capacity = _capacity;
+	}
+
+	bool empty() const noexcept { return _heap.empty(); }
+	auto size() const noexcept { return _heap.size(); }
+
+	bool exist(const Element& _element) const
+	{
+		return _table.contains(_element);
+	}
+
+	bool push(TimeType _time, const Element& _element);
+
+	// 重新设置指定元素的超时时间，若无指定元素则返回false
+	bool reschedule(const Element& _element, TimeType _time);
+
+	bool pop(const Element& _element);
+
+	bool pop(TimeType _time, Vector& _vector);
+
+	// 取出所有元素，不保证时间顺序
+	bool pop(Vector& _vector);
+
+	void clear() noexcept
+	{
+		_heap.clear();
+		_table.clear();
+	}
+};
+
+template <typename _TimeType, typename _Element, std::size_t _ARITY, \
+	template <typename, typename, typename...> class _TableType>
+void HeapTimeoutQueue<_TimeType, _Element, _ARITY, _TableType>::up(SizeType _index) noexcept
+{
+	auto entry = std::move(_heap[_index]);
+	while (_index > 0)
+	{
+		auto parent = (_index - 1) / _ARITY;
+		if (not (entry._time < _heap[parent]._time)) break;
+
+		place(_index, std::move(_heap[parent]));
+		_index = parent;
+	}
+	place(_index, std::move(entry));
+}
+
+template <typename _TimeType, typename _Element, std::size_t _ARITY, \
+	template <typename, typename, typename...> class _TableType>
+void HeapTimeoutQueue<_TimeType, _Element, _ARITY, _TableType>::down(SizeType _index) noexcept
+{
+	auto size = _heap.size();
+	auto entry = std::move(_heap[_index]);
+	while (true)
+	{
+		auto first = _index * _ARITY + 1;
+		if (first >= size) break;
+
+		auto last = first + _ARITY < size ? first + _ARITY : size;
+		auto child = first;
+		for (auto index = first + 1; index < last; ++index)
+			if (_heap[index]._time < _heap[child]._time)
+				child = index;
+
+		if (not (_heap[child]._time < entry._time)) break;
+
+		place(_index, std::move(_heap[child]));
+		_index = child;
+	}
+	place(_index, std::move(entry));
+}
+
+template <typename _TimeType, typename _Element, std::size_t _ARITY, \
+	template <typename, typename, typename...> class _TableType>
+void HeapTimeoutQueue<_TimeType, _Element, _ARITY, _TableType>::erase(SizeType _index) noexcept
+{
+	auto last = _heap.size() - 1;
+	if (_index < last)
+	{
+		auto time = _heap[_index]._time;
+		place(_index, std::move(_heap[last]));
+		_heap.pop_back();
+
+		if (_heap[_index]._time < time) up(_index);
+		else down(_index);
+	}
+	else
+		_heap.pop_back();
+}
+
+template <typename _TimeType, typename _Element, std::size_t _ARITY, \
+	template <typename, typename, typename...> class _TableType>
+bool HeapTimeoutQueue<_TimeType, _Element, _ARITY, _TableType>::push(TimeType _time, \
+	const Element& _element)
+{
+	if (_capacity > 0 and size() >= _capacity) return false;
+
+	auto [iterator, result] = _table.emplace(_element, _heap.size());
+	if (not result) return false;
+
+	try
+	{
+		_heap.push_back(Entry{ _time, &*iterator });
+	}
+	catch (...)
+	{
+		_table.erase(iterator);
+		throw;
+	}
+
+	up(_heap.size() - 1);
+	return true;
+}
+
+template <typename _TimeType, typename _Element, std::size_t _ARITY, \
+	template <typename, typename, typename...> class _TableType>
+bool HeapTimeoutQueue<_TimeType, _Element, _ARITY, _TableType>::reschedule(const Element& _element, \
+	TimeType _time)
+{
+	auto iterator = _table.find(_element);
+	if (iterator == _table.end()) return false;
+
+	auto index = iterator->second;
+	auto& entry = _heap[index];
+	auto time = entry._time;
+	entry._time = _time;
+
+	if (_time < time) up(index);
+	else down(index);
+	return true;
+}
+
+template <typename _TimeType, typename _Element, std::size_t _ARITY, \
+	template <typename, typename, typename...> class _TableType>
+bool HeapTimeoutQueue<_TimeType, _Element, _ARITY, _TableType>::pop(const Element& _element)
+{
+	auto iterator = _table.find(_element);
+	if (iterator == _table.end()) return false;
+
+	erase(iterator->second);
+	_table.erase(iterator);
+	return true;
+}
+
+template <typename _TimeType, typename _Element, std::size_t _ARITY, \
+	template <typename, typename, typename...> class _TableType>
+bool HeapTimeoutQueue<_TimeType, _Element, _ARITY, _TableType>::pop(TimeType _time, \
+	Vector& _vector)
+{
+	auto size = _vector.size();
+	while (not empty() and not (_time < _heap.front()._time))
+	{
+		_vector.push_back(_heap.front()._pair->first);
+		erase(0);
+		_table.erase(_vector.back());
+	}
+	return _vector.size() > size;
+}
+
+template <typename _TimeType, typename _Element, std::size_t _ARITY, \
+	template <typename, typename, typename...> class _TableType>
+bool HeapTimeoutQueue<_TimeType, _Element, _ARITY, _TableType>::pop(Vector& _vector)
+{
+	if (empty()) return false;
+
+	_vector.reserve(_vector.size() + size());
+	for (auto& entry : _heap)
+		_vector.push_back(entry._pair->first);
+
+	clear();
+	return true;
+}
@@ -1,11 +1,19 @@
 ﻿#pragma once
 
+#include <concepts>
+#include <iterator>
 #include <optional>
 #include <utility>
 #include <map>
 #include <vector>
 
-template <typename _TimeType, typename _Element>
+/*
+ * 超时队列
+ * 索引表默认为有序映射，元素须支持operator<；
+ * 可选无序映射std::unordered_map，元素须支持std::hash，查找索引的时间复杂度降为O(1)。
+ */
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType = std::map>
 class TimeoutQueue final
 {
 public:
@@ -17,7 +25,19 @@ public:
 
 private:
 	using QueueType = std::multimap<TimeType, Element>;
-	using TableType = std::map<Element, TimeType>;
+	using Iterator = QueueType::iterator;
+
+	/*
+	 * 记录元素所在的队列节点，弹出指定元素无需遍历同一时间的元素
+	 * 延后超时时间之时，仅更新实际时间，队列节点保留原有时间，待其到期再重新放入。
+	 */
+	struct Index
+	{
+		Iterator _iterator;
+		TimeType _time;
+	};
+
+	using TableType = _TableType<Element, Index>;
 
 private:
 	SizeType _capacity;
@@ -25,7 +45,16 @@ private:
 	TableType _table;
 
 private:
-	void erase(TimeType _time, const Element& _element);
+	// 修改队列节点的时间，复用节点而不重新分配
+	void move(Index& _index, TimeType _time);
+
+	/*
+	 * 依次取出超时元素，转交指定函数处理，返回取出数量
+	 * 倘若指定数量为零，取出所有超时元素，否则取出元素与重新放入延后元素合计至多指定次数，
+	 * 剩余的延后元素留待后续调用重新放入。
+	 */
+	template <typename _Function>
+	SizeType expire(TimeType _time, _Function&& _function, SizeType _size);
 
 public:
 	TimeoutQueue(decltype(_capacity) _capacity = 0) : \
@@ -45,11 +74,59 @@ public:
 		return _table.contains(_element);
 	}
 
+	/*
+	 * 获取队首时间，若队列为空则返回空值
+	 * 延后的超时时间尚未重新放入队列，因此队首时间可能早于实际超时时间。
+	 */
+	std::optional<TimeType> front() const
+	{
+		if (empty()) return std::nullopt;
+		return _queue.cbegin()->first;
+	}
+
 	bool push(TimeType _time, const Element& _element);
 
+	/*
+	 * 重新设置指定元素的超时时间，若无指定元素则返回false
+	 * 延后超时时间无需调整队列，提前超时时间则移动队列节点。
+	 */
+	bool reschedule(const Element& _element, TimeType _time);
+
 	bool pop(const Element& _element);
 
-	bool pop(TimeType _time, Vector& _vector);
+	/*
+	 * 取出超时元素，追加至向量
+	 * 倘若指定数量为零，取出所有超时元素，否则至多取出指定数量的元素，以限制单次耗时。
+	 * 重新放入延后元素亦计入指定数量，因此返回false不代表已无超时元素，可以参照队首时间。
+	 */
+	bool pop(TimeType _time, Vector& _vector, SizeType _size = 0)
+	{
+		return expire(_time, [&_vector](Element&& _element)
+			{
+				_vector.push_back(std::move(_element));
+			}, _size) > 0;
+	}
+
+	// 取出超时元素，转交回调函数处理，返回取出数量
+	template <typename _Function>
+		requires std::invocable<_Function&, Element&&>
+	SizeType pop(TimeType _time, _Function _function, SizeType _size = 0)
+	{
+		return expire(_time, _function, _size);
+	}
+
+	// 取出超时元素，写入输出迭代器，返回写入之后的迭代器
+	template <typename _Iterator>
+		requires std::output_iterator<_Iterator, Element&&>
+	_Iterator pop(TimeType _time, _Iterator _iterator, SizeType _size = 0)
+	{
+		expire(_time, [&_iterator](Element&& _element)
+			{
+				*_iterator++ = std::move(_element);
+			}, _size);
+		return _iterator;
+	}
+
 	bool pop(Vector& _vector);
 
 	void clear() noexcept
@@ -59,64 +136,96 @@ public:
 	}
 };
 
-template <typename _TimeType, typename _Element>
-void TimeoutQueue<_TimeType, _Element>::erase(TimeType _time, \
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType>
+bool TimeoutQueue<_TimeType, _Element, _TableType>::push(TimeType _time, \
 	const Element& _element)
 {
-	auto iterator = _queue.lower_bound(_time);
-	if (iterator == _queue.end()) return;
+	if (_capacity > 0 and size() >= _capacity) return false;
+	if (exist(_element)) return false;
 
-	for (auto end = _queue.upper_bound(_time); \
-		iterator != end; ++iterator)
-		if (iterator->second == _element)
-		{
-			_queue.erase(iterator);
-			break;
-		}
+	auto iterator = _queue.emplace(_time, _element);
+	try
+	{
+		_table.emplace(_element, Index{ iterator, _time });
+	}
+	catch (...)
+	{
+		_queue.erase(iterator);
+		throw;
+	}
+	return true;
 }
 
-template <typename _TimeType, typename _Element>
-bool TimeoutQueue<_TimeType, _Element>::push(TimeType _time, \
-	const Element& _element)
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType>
+void TimeoutQueue<_TimeType, _Element, _TableType>::move(Index& _index, \
+	TimeType _time)
 {
-	if (_capacity > 0 and size() >= _capacity) return false;
-	if (exist(_element)) return false;
+	auto node = _queue.extract(_index._iterator);
+	node.key() = _time;
+	_index._iterator = _queue.insert(std::move(node));
+	_index._time = _time;
+}
 
-	_queue.emplace(_time, _element);
-	_table.emplace(_element, _time);
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType>
+bool TimeoutQueue<_TimeType, _Element, _TableType>::reschedule(const Element& _element, \
+	TimeType _time)
+{
+	auto iterator = _table.find(_element);
+	if (iterator == _table.end()) return false;
+
+	auto& index = iterator->second;
+	if (_time < index._iterator->first) move(index, _time);
+	else index._time = _time;
 	return true;
 }
 
-template <typename _TimeType, typename _Element>
-bool TimeoutQueue<_TimeType, _Element>::pop(const Element& _element)
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType>
+bool TimeoutQueue<_TimeType, _Element, _TableType>::pop(const Element& _element)
 {
 	auto iterator = _table.find(_element);
 	if (iterator == _table.end()) return false;
 
-	erase(iterator->second, _element);
+	_queue.erase(iterator->second._iterator);
 	_table.erase(iterator);
 	return true;
 }
 
-template <typename _TimeType, typename _Element>
-bool TimeoutQueue<_TimeType, _Element>::pop(TimeType _time, Vector& _vector)
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType>
+template <typename _Function>
+auto TimeoutQueue<_TimeType, _Element, _TableType>::expire(TimeType _time, \
+	_Function&& _function, SizeType _size) -> SizeType
 {
-	auto size = _vector.size();
-	for (auto iterator = _queue.begin(), end = _queue.upper_bound(_time); \
-		iterator != end; iterator = _queue.erase(iterator))
+	SizeType count = 0, step = 0;
+	for (; not empty() and (_size <= 0 or step < _size); ++step)
 	{
-		auto& element = iterator->second;
-		if (auto iterator = _table.find(element); iterator != _table.end())
+		auto iterator = _queue.begin();
+		if (_time < iterator->first) break;
+
+		auto position = _table.find(iterator->second);
+
+		// 实际时间已被延后，重新放入队列
+		if (auto& index = position->second; _time < index._time)
 		{
-			_vector.push_back(std::move(element));
-			_table.erase(iterator);
+			move(index, index._time);
+			continue;
 		}
+
+		_function(std::move(iterator->second));
+		_table.erase(position);
+		_queue.erase(iterator);
+		++count;
 	}
-	return _vector.size() > size;
+	return count;
 }
 
-template <typename _TimeType, typename _Element>
-bool TimeoutQueue<_TimeType, _Element>::pop(Vector& _vector)
+template <typename _TimeType, typename _Element, \
+	template <typename, typename, typename...> class _TableType>
+bool TimeoutQueue<_TimeType, _Element, _TableType>::pop(Vector& _vector)
 {
 	if (empty()) return false;
 
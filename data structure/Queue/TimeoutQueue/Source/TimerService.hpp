@@ -0,0 +1,224 @@
+﻿#pragma once
+
+#include "TimeoutQueue.hpp"
+
+#include <exception>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <map>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/*
+ * 定时器服务
+ * 以超时队列管理定时器，后台线程休眠至最早的超时时间，或者放入更早的定时器之时提前唤醒，
+ * 批量取出超时元素并回调，回调函数可以将元素转交执行器。所有方法均为线程安全。
+ */
+template <typename _Element, typename _Clock = std::chrono::steady_clock, \
+	template <typename, typename, typename...> class _TableType = std::map>
+class TimerService final
+{
+public:
+	using Element = _Element;
+	using Clock = _Clock;
+	using TimePoint = Clock::time_point;
+
+	using QueueType = TimeoutQueue<TimePoint, Element, _TableType>;
+	using Vector = QueueType::Vector;
+	using SizeType = QueueType::SizeType;
+
+	/*
+	 * 批量处理超时元素，于后台线程调用，调用期间不持有锁
+	 * 抛出的异常由服务捕获并记录，不会终止后台线程；可以于回调之中停止服务，但是不可析构服务。
+	 */
+	using Callback = std::function<void(Vector&)>;
+
+private:
+	mutable std::mutex _mutex;
+	std::condition_variable _condition;
+	QueueType _queue;
+	bool _running;
+	std::exception_ptr _exception;
+
+	Callback _callback;
+	SizeType _batch;
+	Vector _vector;
+
+	std::thread _thread;
+	std::once_flag _joined;
+
+private:
+	// 若指定时间早于队首时间，则唤醒后台线程重新设置休眠时间
+	void notify(const std::optional<TimePoint>& _front, TimePoint _time)
+	{
+		if (not _front or _time < *_front)
+			_condition.notify_one();
+	}
+
+	void execute();
+
+public:
+	/*
+	 * 若批量大小为零，每次回调所有超时元素，否则每次至多回调指定数量的元素，
+	 * 各批次之间释放锁，以免大量元素同时超时而长期阻塞其他线程。
+	 */
+	explicit TimerService(const Callback& _callback, \
+		SizeType _capacity = 0, SizeType _batch = 0) : \
+		_queue(_capacity), _running(true), \
+		_callback(_callback), _batch(_batch), \
+		_thread(&TimerService::execute, this) {}
+
+	TimerService(const TimerService&) = delete;
+
+	~TimerService() { stop(); }
+
+	TimerService& operator=(const TimerService&) = delete;
+
+	bool empty() const
+	{
+		std::lock_guard lock(_mutex);
+		return _queue.empty();
+	}
+
+	auto size() const
+	{
+		std::lock_guard lock(_mutex);
+		return _queue.size();
+	}
+
+	bool exist(const Element& _element) const
+	{
+		std::lock_guard lock(_mutex);
+		return _queue.exist(_element);
+	}
+
+	bool push(TimePoint _time, const Element& _element);
+
+	template <typename _Rep, typename _Period>
+	bool push(const std::chrono::duration<_Rep, _Period>& _duration, \
+		const Element& _element)
+	{
+		return push(Clock::now() + _duration, _element);
+	}
+
+	bool reschedule(const Element& _element, TimePoint _time);
+
+	template <typename _Rep, typename _Period>
+	bool reschedule(const Element& _element, \
+		const std::chrono::duration<_Rep, _Period>& _duration)
+	{
+		return reschedule(_element, Clock::now() + _duration);
+	}
+
+	bool pop(const Element& _element)
+	{
+		std::lock_guard lock(_mutex);
+		return _queue.pop(_element);
+	}
+
+	void clear()
+	{
+		std::lock_guard lock(_mutex);
+		_queue.clear();
+	}
+
+	// 取出回调函数最近一次抛出的异常，若无异常则返回空指针
+	std::exception_ptr exception()
+	{
+		std::lock_guard lock(_mutex);
+		return std::exchange(_exception, nullptr);
+	}
+
+	/*
+	 * 停止后台线程，未超时的元素保留于队列
+	 * 于回调函数之中调用，仅通知后台线程于回调返回之后退出，由析构或者其他线程回收。
+	 */
+	void stop();
+};
+
+template <typename _Element, typename _Clock, \
+	template <typename, typename, typename...> class _TableType>
+void TimerService<_Element, _Clock, _TableType>::execute()
+{
+	std::unique_lock lock(_mutex);
+	while (_running)
+	{
+		auto front = _queue.front();
+		if (not front)
+		{
+			_condition.wait(lock);
+			continue;
+		}
+
+		if (Clock::now() < *front)
+		{
+			_condition.wait_until(lock, *front);
+			continue;
+		}
+
+		// 仅重新放入延后的定时器之时，亦于批次之间释放锁
+		auto result = _queue.pop(Clock::now(), _vector, _batch);
+
+		lock.unlock();
+		if (result)
+		{
+			try
+			{
+				_callback(_vector);
+			}
+			catch (...)
+			{
+				std::lock_guard guard(_mutex);
+				_exception = std::current_exception();
+			}
+			_vector.clear();
+		}
+		lock.lock();
+	}
+}
+
+template <typename _Element, typename _Clock, \
+	template <typename, typename, typename...> class _TableType>
+bool TimerService<_Element, _Clock, _TableType>::push(TimePoint _time, \
+	const Element& _element)
+{
+	std::lock_guard lock(_mutex);
+	auto front = _queue.front();
+	if (not _queue.push(_time, _element)) return false;
+
+	notify(front, _time);
+	return true;
+}
+
+template <typename _Element, typename _Clock, \
+	template <typename, typename, typename...> class _TableType>
+bool TimerService<_Element, _Clock, _TableType>::reschedule(const Element& _element, \
+	TimePoint _time)
+{
+	std::lock_guard lock(_mutex);
+	auto front = _queue.front();
+	if (not _queue.reschedule(_element, _time)) return false;
+
+	notify(front, _time);
+	return true;
+}
+
+template <typename _Element, typename _Clock, \
+	template <typename, typename, typename...> class _TableType>
+void TimerService<_Element, _Clock, _TableType>::stop()
+{
+	{
+		std::lock_guard lock(_mutex);
+		_running = false;
+	}
+
+	_condition.notify_one();
+
+	// 后台线程不可等待自身，否则抛出resource_deadlock_would_occur
+	if (std::this_thread::get_id() == _thread.get_id()) return;
+
+	std::call_once(_joined, [this] { _thread.join(); });
+}
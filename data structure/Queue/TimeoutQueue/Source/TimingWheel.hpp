@@ -0,0 +1,373 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * 分层时间轮
+ * 接口与超时队列一致，时间因子为非负整数刻度，元素须支持std::hash。
+ * 放入与弹出指定元素的时间复杂度为O(1)，批量取出超时元素的均摊时间复杂度为O(1)。
+ */
+template <typename _TimeType, typename _Element, \
+	std::size_t _LEVELS = 4, std::size_t _BITS = 8>
+class TimingWheel final
+{
+	static_assert(std::is_integral_v<_TimeType>, \
+		"The time type of a timing wheel must be integral.");
+	static_assert(_LEVELS > 0 && _BITS > 0, \
+		"A timing wheel requires at least one level and one bit.");
+
+public:
+	using TimeType = _TimeType;
+	using Element = _Element;
+
+	using Vector = std::vector<Element>;
+	using SizeType = Vector::size_type;
+
+private:
+	using TickType = std::make_unsigned_t<TimeType>;
+
+	struct Node
+	{
+		Element _element;
+		TimeType _time;
+		SizeType _slot;
+		SizeType _prev;
+		SizeType _next;
+	};
+
+	using NodeList = std::vector<Node>;
+	using TableType = std::unordered_map<Element, SizeType>;
+
+private:
+	static constexpr SizeType NIL = std::numeric_limits<SizeType>::max();
+
+	static constexpr SizeType SLOTS = SizeType(1) << _BITS;
+	static constexpr SizeType MASK = SLOTS - 1;
+
+	// 超出最高层跨度的元素
+	static constexpr SizeType OVERFLOW_SLOT = _LEVELS * SLOTS;
+
+	// 已经到期的元素
+	static constexpr SizeType EXPIRED_SLOT = OVERFLOW_SLOT + 1;
+
+private:
+	SizeType _capacity;
+
+	/*
+	 * 当前刻度，仅由批量取出推进，放入元素不会改变
+	 * 不晚于当前刻度的元素才转入到期槽，否则提前放入的较早元素也将滞留于到期槽，致使每次取出均遍历之。
+	 */
+	TimeType _current;
+
+	NodeList _nodeList;
+	SizeType _free;
+
+	std::array<SizeType, EXPIRED_SLOT + 1> _slots;
+	std::array<SizeType, _LEVELS> _counts;
+
+	TableType _table;
+
+private:
+	// 获取刻度在指定层的块号，位移超出位宽则为零
+	static TickType block(TimeType _time, SizeType _level) noexcept
+	{
+		auto shift = _BITS * _level;
+		return shift < std::numeric_limits<TickType>::digits ? \
+			static_cast<TickType>(_time) >> shift : 0;
+	}
+
+	// 获取指定层下一块的起始刻度
+	static TimeType boundary(TimeType _time, SizeType _level) noexcept
+	{
+		auto shift = _BITS * _level;
+		return static_cast<TimeType>((block(_time, _level) + 1) << shift);
+	}
+
+	SizeType locate(TimeType _time) const noexcept;
+
+	void link(SizeType _index, SizeType _slot) noexcept;
+	void unlink(SizeType _index) noexcept;
+
+	SizeType allocate(TimeType _time, const Element& _element);
+	void release(SizeType _index) noexcept;
+
+	// 重新放置指定槽的所有元素
+	void cascade(SizeType _slot) noexcept;
+
+	// 推进当前刻度，到期元素转入到期槽
+	void advance(TimeType _time) noexcept;
+
+public:
+	TimingWheel(decltype(_capacity) _capacity = 0) : \
+		_capacity(_capacity), _current(0), _free(NIL), _counts{}
+	{
+		_slots.fill(NIL);
+	}
+
+	auto capacity() const noexcept { return _capacity; }
+	void reserve(decltype(_capacity) _capacity) noexcept
+	{
+		this->_capacity = _capacity;
+	}
+
+	bool empty() const noexcept { return _table.empty(); }
+	auto size() const noexcept { return _table.size(); }
+
+	bool exist(const Element& _element) const
+	{
+		return _table.contains(_element);
+	}
+
+	bool push(TimeType _time, const Element& _element);
+
+	// 重新设置指定元素的超时时间，若无指定元素则返回false
+	bool reschedule(const Element& _element, TimeType _time);
+
+	bool pop(const Element& _element);
+
+	bool pop(TimeType _time, Vector& _vector);
+
+	// 取出所有元素，不保证时间顺序
+	bool pop(Vector& _vector);
+
+	void clear() noexcept;
+};
+
+template <typename _TimeType, typename _Element, \
+	std::size_t _LEVELS, std::size_t _BITS>
+auto TimingWheel<_TimeType, _Element, _LEVELS, _BITS>::locate(TimeType _time) const noexcept \
+-> SizeType
+{
+	if (_time <= _current) return EXPIRED_SLOT;
+
+	for (SizeType level = 0; level < _LEVELS; ++level)
+		if (block(_time, level + 1) == block(_current, level + 1))
+			return level * SLOTS + (block(_time, level) & MASK);
+	return OVERFLOW_SLOT;
+}
+
+template <typename _TimeType, typename _Element, \
+	std::size_t _LEVELS, std::size_t _BITS>
+void TimingWheel<_TimeType, _Element, _LEVELS, _BITS>::link(SizeType _index, \
+	SizeType _slot) noexcept
+{
+	auto& node = _nodeList[_index];
+	auto& head = _slots[_slot];
+
+	node._slot = _slot;
+	node._prev = NIL;
+	node._next = head;
+	if (head != NIL) _nodeList[head]._prev = _index;
+	head = _index;
+
+	if (_slot < OVERFLOW_SLOT) ++_counts[_slot / SLOTS];
+}
+
+template <typename _TimeType, typename _Element, \
+	std::size_t _LEVELS, std::size_t _BITS>
+void TimingWheel<_TimeType, _Element, _LEVELS, _BITS>::unlink(SizeType _index) noexcept
+{
+	auto& node = _nodeList[_index];
+	if (node._prev != NIL) _nodeList[node._prev]._next = node._next;
+	else _slots[node._slot] = node._next;
+	if (node._next != NIL) _nodeList[node._next]._prev = node._prev;
+
+	if (node._slot < OVERFLOW_SLOT) --_counts[node._slot / SLOTS];
+}
+
+template <typename _TimeType, typename _Element, \
+	std::size_t _LEVELS, std::size_t _BITS>
+auto TimingWheel<_TimeType, _Element, _LEVELS, _BITS>::allocate(TimeType _time, \
+	const Element& _element) -> SizeType
+{
+	if (_free == NIL)
+	{
+		_nodeList.push_back(Node{ _element, _time, NIL, NIL, NIL });
+		return _nodeList.size() - 1;
+	}
+
+	auto index = _free;
+	auto& node = _nodeList[index];
+	_free = node._next;
+
+	node._element = _element;
+	node._time = _time;
+	return index;
+}
+
+template <typename _TimeType, typename _Element, \
+	std::size_t _LEVELS, std::size_t _BITS>
+void TimingWheel<_TimeType, _Element, _LEVELS, _BITS>::release(SizeType _index) noexcept
+{
+	auto& node = _nodeList[_index];
+	node._slot = NIL;
+	node._next = _free;
+	_free = _index;
+}
+
+template <typename _TimeType, typename _Element, \
+	std::size_t _LEVELS, std::size_t _BITS>
+void TimingWheel<_TimeType, _Element, _LEVELS, _BITS>::cascade(SizeType _slot) noexcept
+{
+	auto index = _slots[_slot];
+	while (index != NIL)
+	{
+		auto next = _nodeList[index]._next;
+		unlink(index);
+		link(index, locate(_nodeList[index]._time));
+		index = next;
+	}
+}
+
+template <typename _TimeType, typename _Element, \
+	std::size_t _LEVELS, std::size_t _BITS>
+void TimingWheel<_TimeType, _Element, _LEVELS, _BITS>::advance(TimeType _time) noexcept
+{
+	while (_current < _time)
+	{
+		// 跳过最低的若干空层，直接推进至最低非空层的下一块
+		SizeType level = 0;
+		while (level < _LEVELS && _counts[level] <= 0) ++level;
+
+		// 各层皆空，直接推进至指定时间，仅当最高层跨越块之时重新放置溢出元素
+		if (level >= _LEVELS)
+		{
+			auto overflow = block(_current, _LEVELS) != block(_time, _LEVELS);
+			_current = _time;
+			if (overflow) cascade(OVERFLOW_SLOT);
+			break;
+		}
+
+		auto next = level > 0 ? boundary(_current, level) : _current + 1;
+		if (next <= _current || next > _time)
+		{
+			_current = _time;
+			break;
+		}
+		_current = next;
+
+		// 低位全零的层均进入新块，自高至低级联对应的槽
+		SizeType top = 0;
+		while (top < _LEVELS && (block(_current, top) & MASK) == 0) ++top;
+		if (top >= _LEVELS)
+		{
+			cascade(OVERFLOW_SLOT);
+			top = _LEVELS - 1;
+		}
+
+		for (; top > 0; --top)
+			cascade(top * SLOTS + (block(_current, top) & MASK));
+
+		cascade(block(_current, 0) & MASK);
+	}
+}
+
+template <typename _TimeType, typename _Element, \
+	std::size_t _LEVELS, std::size_t _BITS>
+bool TimingWheel<_TimeType, _Element, _LEVELS, _BITS>::push(TimeType _time, \
+	const Element& _element)
+{
+	if (_capacity > 0 and size() >= _capacity) return false;
+	if (exist(_element)) return false;
+
+	auto index = allocate(_time, _element);
+	try
+	{
+		_table.emplace(_element, index);
+	}
+	catch (...)
+	{
+		release(index);
+		throw;
+	}
+
+	link(index, locate(_time));
+	return true;
+}
+
+template <typename _TimeType, typename _Element, \
+	std::size_t _LEVELS, std::size_t _BITS>
+bool TimingWheel<_TimeType, _Element, _LEVELS, _BITS>::reschedule(const Element& _element, \
+	TimeType _time)
+{
+	auto iterator = _table.find(_element);
+	if (iterator == _table.end()) return false;
+
+	auto index = iterator->second;
+	_nodeList[index]._time = _time;
+	unlink(index);
+	link(index, locate(_time));
+	return true;
+}
+
+template <typename _TimeType, typename _Element, \
+	std::size_t _LEVELS, std::size_t _BITS>
+bool TimingWheel<_TimeType, _Element, _LEVELS, _BITS>::pop(const Element& _element)
+{
+	auto iterator = _table.find(_element);
+	if (iterator == _table.end()) return false;
+
+	auto index = iterator->second;
+	unlink(index);
+	release(index);
+	_table.erase(iterator);
+	return true;
+}
+
+template <typename _TimeType, typename _Element, \
+	std::size_t _LEVELS, std::size_t _BITS>
+bool TimingWheel<_TimeType, _Element, _LEVELS, _BITS>::pop(TimeType _time, \
+	Vector& _vector)
+{
+	advance(_time);
+
+	auto size = _vector.size();
+	for (auto index = _slots[EXPIRED_SLOT]; index != NIL;)
+	{
+		auto& node = _nodeList[index];
+		auto next = node._next;
+
+		// 时间倒退之时，到期槽可能存有晚于指定时间的元素
+		if (node._time <= _time)
+		{
+			unlink(index);
+			_table.erase(node._element);
+			_vector.push_back(std::move(node._element));
+			release(index);
+		}
+		index = next;
+	}
+	return _vector.size() > size;
+}
+
+template <typename _TimeType, typename _Element, \
+	std::size_t _LEVELS, std::size_t _BITS>
+bool TimingWheel<_TimeType, _Element, _LEVELS, _BITS>::pop(Vector& _vector)
+{
+	if (empty()) return false;
+
+	_vector.reserve(_vector.size() + size());
+	for (auto& node : _nodeList)
+		if (node._slot != NIL)
+			_vector.push_back(std::move(node._element));
+
+	clear();
+	return true;
+}
+
+template <typename _TimeType, typename _Element, \
+	std::size_t _LEVELS, std::size_t _BITS>
+void TimingWheel<_TimeType, _Element, _LEVELS, _BITS>::clear() noexcept
+{
+	_nodeList.clear();
+	_free = NIL;
+	_slots.fill(NIL);
+	_counts.fill(0);
+	_table.clear();
+}
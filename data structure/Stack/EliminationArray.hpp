@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+/*
+ * 消除数组
+ * 入栈与出栈竞争栈顶失败之后，转而在消除数组中相遇，入栈线程直接将节点交给出栈线程，二者都无需访问栈顶。
+ * 入栈线程占用空闲槽位并且等待，出栈线程取走槽位中的节点，并且以标记告知入栈线程交换成功。
+ * 每个线程自适应调整访问的槽位范围与等待时长：槽位冲突则扩大范围，等待超时则缩小范围并且延长等待。
+ */
+template <typename node_type, size_t CAPACITY = 8>
+class EliminationArray
+{
+	static_assert(CAPACITY > 0, "The capacity of an elimination array must be positive.");
+
+	static constexpr size_t CACHE_LINE = 64;
+	static constexpr size_t MIN_SPIN = 16;
+	static constexpr size_t MAX_SPIN = 1024;
+
+	// 槽位独占缓存行，避免伪共享
+	struct alignas(CACHE_LINE) Slot
+	{
+		std::atomic<node_type*> pointer;
+
+		Slot() : pointer(nullptr) {}
+	};
+
+	// 线程的槽位范围、等待时长与随机数状态
+	struct State
+	{
+		size_t width;
+		size_t spin;
+		uint32_t seed;
+
+		State() : width(1), spin(MIN_SPIN), \
+			seed(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(this)) | 1) {}
+	};
+
+	Slot slots[CAPACITY];
+
+private:
+	// 出栈线程取走节点之后写入的标记，不与任何节点地址相同
+	static node_type* taken() noexcept
+	{
+		static char sentinel;
+		return reinterpret_cast<node_type*>(&sentinel);
+	}
+
+	static State& state()
+	{
+		thread_local State state;
+		return state;
+	}
+
+	static Slot& choose(Slot* slots, State& state) noexcept
+	{
+		state.seed ^= state.seed << 13;
+		state.seed ^= state.seed >> 17;
+		state.seed ^= state.seed << 5;
+		return slots[state.seed % state.width];
+	}
+
+	static void expand(State& state) noexcept
+	{
+		if (state.width < CAPACITY)
+			state.width = state.width * 2 < CAPACITY ? state.width * 2 : CAPACITY;
+	}
+
+	static void shrink(State& state) noexcept
+	{
+		if (state.width > 1)
+			state.width /= 2;
+	}
+
+public:
+	EliminationArray() = default;
+
+	EliminationArray(const EliminationArray&) = delete;
+
+	EliminationArray& operator=(const EliminationArray&) = delete;
+
+	// 提供节点以待出栈线程取走，成功交换则返回true，否则节点仍归调用者所有
+	bool push(node_type* node) noexcept
+	{
+		auto& state = EliminationArray::state();
+		auto& pointer = choose(slots, state).pointer;
+
+		node_type* expected = nullptr;
+		if (!pointer.compare_exchange_strong(expected, node, \
+			std::memory_order_release, std::memory_order_relaxed))
+		{
+			expand(state);
+			return false;
+		}
+
+		for (size_t count = 0; count < state.spin; ++count)
+			if (pointer.load(std::memory_order_relaxed) == taken())
+			{
+				pointer.store(nullptr, std::memory_order_relaxed);
+				if (state.spin > MIN_SPIN)
+					state.spin /= 2;
+				return true;
+			}
+
+		// 等待超时，撤回节点；撤回失败说明节点恰好被取走
+		expected = node;
+		if (pointer.compare_exchange_strong(expected, nullptr, \
+			std::memory_order_relaxed, std::memory_order_relaxed))
+		{
+			shrink(state);
+			if (state.spin < MAX_SPIN)
+				state.spin *= 2;
+			return false;
+		}
+
+		pointer.store(nullptr, std::memory_order_relaxed);
+		return true;
+	}
+
+	// 取走入栈线程提供的节点，若无则返回空指针
+	node_type* pop() noexcept
+	{
+		auto& state = EliminationArray::state();
+		auto& pointer = choose(slots, state).pointer;
+
+		node_type* node = pointer.load(std::memory_order_relaxed);
+		if (node == nullptr || node == taken())
+		{
+			shrink(state);
+			return nullptr;
+		}
+
+		if (!pointer.compare_exchange_strong(node, taken(), \
+			std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			expand(state);
+			return nullptr;
+		}
+		return node;
+	}
+};
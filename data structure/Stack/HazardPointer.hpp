@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+/*
+ * 风险指针
+ * 每个线程占用一条风险记录，访问共享节点之前发布其地址。
+ * 线程延迟释放已摘除的节点，待退役列表达到阈值，再扫描所有风险记录，释放无人访问的节点。
+ */
+class HazardPointer
+{
+	struct Record
+	{
+		std::atomic<bool> active;
+		std::atomic<const void*> pointer;
+		Record* next;
+
+		Record() : active(true), pointer(nullptr), next(nullptr) {}
+	};
+
+	struct Retired
+	{
+		void* pointer;
+		void (*deleter)(void*);
+	};
+
+	// 全局风险记录链表，只增不减，以及线程退出之时尚未释放的节点
+	struct Domain
+	{
+		std::atomic<Record*> head;
+		std::atomic<size_t> size;
+
+		std::mutex mutex;
+		std::vector<Retired> orphans;
+
+		Domain() : head(nullptr), size(0) {}
+		~Domain();
+	};
+
+	// 线程独占的风险记录与退役列表
+	struct Owner
+	{
+		Record* record;
+		std::vector<Retired> retired;
+
+		Owner() : record(acquire()) {}
+		~Owner();
+	};
+
+	static constexpr size_t THRESHOLD = 64;
+
+private:
+	static Domain& domain()
+	{
+		static Domain domain;
+		return domain;
+	}
+
+	static Owner& owner()
+	{
+		thread_local Owner owner;
+		return owner;
+	}
+
+	static Record* acquire();
+
+	static void scan(std::vector<Retired>& retired);
+
+public:
+	// 发布共享指针的当前值，并且确保发布之后该值仍然有效
+	template <typename node_type>
+	static node_type* protect(const std::atomic<node_type*>& source) noexcept
+	{
+		auto& pointer = owner().record->pointer;
+		node_type* node = source.load(std::memory_order_relaxed);
+		while (true)
+		{
+			pointer.store(node);
+			node_type* current = source.load();
+			if (current == node)
+				return node;
+			node = current;
+		}
+	}
+
+	// 撤销当前线程发布的指针
+	static void clear() noexcept
+	{
+		owner().record->pointer.store(nullptr, std::memory_order_release);
+	}
+
+	// 退役已从共享结构摘除的节点，待其无人访问再以指定函数释放
+	static void retire(void* pointer, void (*deleter)(void*));
+
+	template <typename node_type>
+	static void retire(node_type* node)
+	{
+		retire(node, [](void* pointer) { delete static_cast<node_type*>(pointer); });
+	}
+};
+
+inline HazardPointer::Domain::~Domain()
+{
+	for (auto& retired : orphans)
+		retired.deleter(retired.pointer);
+
+	for (Record* record = head.load(); record != nullptr;)
+	{
+		Record* next = record->next;
+		delete record;
+		record = next;
+	}
+}
+
+inline HazardPointer::Owner::~Owner()
+{
+	record->pointer.store(nullptr);
+	scan(retired);
+
+	auto& domain = HazardPointer::domain();
+	if (!retired.empty())
+	{
+		std::lock_guard<std::mutex> lock(domain.mutex);
+		domain.orphans.insert(domain.orphans.end(), retired.begin(), retired.end());
+	}
+
+	record->active.store(false, std::memory_order_release);
+}
+
+inline auto HazardPointer::acquire() -> Record*
+{
+	auto& domain = HazardPointer::domain();
+	for (Record* record = domain.head.load(std::memory_order_acquire); \
+		record != nullptr; record = record->next)
+	{
+		bool active = false;
+		if (!record->active.load(std::memory_order_relaxed) \
+			&& record->active.compare_exchange_strong(active, true, std::memory_order_acquire))
+			return record;
+	}
+
+	Record* record = new Record;
+	record->next = domain.head.load(std::memory_order_relaxed);
+	while (!domain.head.compare_exchange_weak(record->next, record, \
+		std::memory_order_release, std::memory_order_relaxed));
+	domain.size.fetch_add(1, std::memory_order_relaxed);
+	return record;
+}
+
+inline void HazardPointer::scan(std::vector<Retired>& retired)
+{
+	auto& domain = HazardPointer::domain();
+	{
+		std::unique_lock<std::mutex> lock(domain.mutex, std::try_to_lock);
+		if (lock.owns_lock() && !domain.orphans.empty())
+		{
+			retired.insert(retired.end(), domain.orphans.begin(), domain.orphans.end());
+			domain.orphans.clear();
+		}
+	}
+
+	std::vector<const void*> hazards;
+	hazards.reserve(domain.size.load(std::memory_order_relaxed));
+	for (Record* record = domain.head.load(std::memory_order_acquire); \
+		record != nullptr; record = record->next)
+		if (const void* pointer = record->pointer.load())
+			hazards.push_back(pointer);
+	std::sort(hazards.begin(), hazards.end());
+
+	auto end = std::partition(retired.begin(), retired.end(), \
+		[&hazards](const Retired& retired)
+		{
+			return std::binary_search(hazards.begin(), hazards.end(), retired.pointer);
+		});
+
+	for (auto iterator = end; iterator != retired.end(); ++iterator)
+		iterator->deleter(iterator->pointer);
+	retired.erase(end, retired.end());
+}
+
+inline void HazardPointer::retire(void* pointer, void (*deleter)(void*))
+{
+	auto& owner = HazardPointer::owner();
+	owner.retired.push_back({ pointer, deleter });
+
+	auto& domain = HazardPointer::domain();
+	if (owner.retired.size() >= THRESHOLD + 2 * domain.size.load(std::memory_order_relaxed))
+		scan(owner.retired);
+}
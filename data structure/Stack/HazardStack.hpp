@@ -0,0 +1,179 @@
+#pragma once
+
+#include "HazardPointer.hpp"
+
+#include <utility>
+#include <memory>
+#include <atomic>
+
+#if __cplusplus >= 201703L || defined(_MSVC_LANG) && _MSVC_LANG >= 201703L
+#include <optional>
+#define STACK_OPTIONAL
+#endif
+
+/*
+ * 基于风险指针的无锁并发链栈
+ * 出栈先以风险指针保护栈顶节点，再以一次比较和交换摘除节点，而后退役节点，待无人访问再释放。
+ * 相比分离引用计数，无需双字原子操作，出栈在无竞争之时只需一次比较和交换。
+ */
+template <typename data_type>
+class HazardStack
+{
+	// 数据直接存储于节点，其他线程经由风险指针只访问next，不访问data
+	struct Node
+	{
+		data_type data;
+		Node* next;
+
+		template <typename... argument_types>
+		explicit Node(argument_types&&... arguments)
+			: data(std::forward<argument_types>(arguments)...), next(nullptr) {}
+	};
+
+	std::atomic<Node*> head;
+private:
+	// 摘除栈顶节点，以指定函数取走数据，栈为空则返回false
+	template <typename consumer_type>
+	bool take(consumer_type&& consume)
+	{
+		Node* node = HazardPointer::protect(head);
+		while (node != nullptr && !head.compare_exchange_weak(node, node->next))
+			node = HazardPointer::protect(head);
+		HazardPointer::clear();
+
+		if (node == nullptr)
+			return false;
+
+		try
+		{
+			consume(node->data);
+		}
+		catch (...)
+		{
+			HazardPointer::retire(node);
+			throw;
+		}
+		HazardPointer::retire(node);
+		return true;
+	}
+
+	// 退役整条链表，其他线程可能仍以风险指针访问其中的节点
+	static void discard(Node* node)
+	{
+		while (node != nullptr)
+		{
+			Node* next = node->next;
+			HazardPointer::retire(node);
+			node = next;
+		}
+	}
+public:
+	HazardStack() : head(nullptr) {}
+
+	HazardStack(const HazardStack&) = delete;
+
+	~HazardStack()
+	{
+		for (Node* node = head.load(std::memory_order_relaxed); node != nullptr;)
+		{
+			Node* next = node->next;
+			delete node;
+			node = next;
+		}
+	}
+
+	HazardStack& operator=(const HazardStack&) = delete;
+
+	void push(const data_type& data) { emplace(data); }
+	void push(data_type&& data) { emplace(std::move(data)); }
+
+	template <typename... argument_types>
+	void emplace(argument_types&&... arguments)
+	{
+		Node* node = new Node(std::forward<argument_types>(arguments)...);
+		node->next = head.load(std::memory_order_relaxed);
+		while (!head.compare_exchange_weak(node->next, node, \
+			std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	// 预先链接区间的所有元素，再以一次比较和交换入栈，区间末尾的元素位于栈顶
+	template <typename input_iterator>
+	void push_range(input_iterator first, input_iterator last)
+	{
+		if (first == last)
+			return;
+
+		Node* bottom = new Node(*first);
+		Node* top = bottom;
+		try
+		{
+			for (++first; first != last; ++first)
+			{
+				Node* node = new Node(*first);
+				node->next = top;
+				top = node;
+			}
+		}
+		catch (...)
+		{
+			while (top != nullptr)
+			{
+				Node* next = top->next;
+				delete top;
+				top = next;
+			}
+			throw;
+		}
+
+		bottom->next = head.load(std::memory_order_relaxed);
+		while (!head.compare_exchange_weak(bottom->next, top, \
+			std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	// 以一次交换摘除所有节点，按照出栈顺序写入输出迭代器，返回写入之后的迭代器
+	template <typename output_iterator>
+	output_iterator pop_all(output_iterator iterator)
+	{
+		Node* node = head.exchange(nullptr, std::memory_order_acquire);
+		while (node != nullptr)
+		{
+			Node* next = node->next;
+			try
+			{
+				*iterator++ = std::move(node->data);
+			}
+			catch (...)
+			{
+				HazardPointer::retire(node);
+				discard(next);
+				throw;
+			}
+			HazardPointer::retire(node);
+			node = next;
+		}
+		return iterator;
+	}
+
+	// 出栈至调用者提供的对象，栈为空则返回false
+	bool pop(data_type& data)
+	{
+		return take([&data](data_type& value) { data = std::move(value); });
+	}
+
+#ifdef STACK_OPTIONAL
+	std::optional<data_type> try_pop()
+	{
+		std::optional<data_type> data;
+		take([&data](data_type& value) { data.emplace(std::move(value)); });
+		return data;
+	}
+#endif
+
+	// 兼容接口，出栈数据需要另行分配共享指针
+	std::shared_ptr<data_type> pop()
+	{
+		std::shared_ptr<data_type> data;
+		take([&data](data_type& value) { data = std::make_shared<data_type>(std::move(value)); });
+		return data;
+	}
+};
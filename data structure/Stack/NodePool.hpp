@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+/*
+ * 无锁节点池
+ * 每个线程缓存空闲节点，分配与回收只访问线程缓存，无需同步。
+ * 线程缓存为空则从全局池批量取回节点，过多则批量归还，全局池以带标签的指针实现无锁栈，避免ABA问题。
+ * 节点内存按批申请，直至全局池析构才释放，因此过期线程读取空闲节点的链接仍然安全。
+ */
+template <typename object_type, size_t BATCH = 64>
+class NodePool
+{
+	static_assert(BATCH > 0, "The batch size of a node pool must be positive.");
+
+	static constexpr size_t SIZE = sizeof(object_type) > sizeof(void*) \
+		? sizeof(object_type) : sizeof(void*);
+
+	// 存储区位于首部，与块地址相同；链接位于存储区之外，对象构造与析构不影响链接
+	struct Block
+	{
+		alignas(object_type) unsigned char storage[SIZE];
+		std::atomic<Block*> next;
+
+		// 全局池的每个批次以首块链接下一批次，首块的存储区记录批次内的后继块
+		Block*& successor() noexcept { return *reinterpret_cast<Block**>(storage); }
+	};
+
+	struct TaggedPointer
+	{
+		Block* block;
+		size_t tag;
+	};
+
+	struct Global
+	{
+		std::atomic<TaggedPointer> head;
+
+		std::mutex mutex;
+		std::vector<Block*> chunks;
+
+		Global() : head(TaggedPointer{ nullptr, 0 }) {}
+		~Global()
+		{
+			for (auto chunk : chunks)
+				delete[] chunk;
+		}
+	};
+
+	// 线程缓存，线程退出之时归还全局池
+	struct Cache
+	{
+		Block* head;
+		size_t size;
+
+		Cache() : head(nullptr), size(0) {}
+		~Cache()
+		{
+			if (head != nullptr)
+				push(head);
+		}
+	};
+
+private:
+	static Global& global()
+	{
+		static Global global;
+		return global;
+	}
+
+	static Cache& cache()
+	{
+		thread_local Cache cache;
+		return cache;
+	}
+
+	// 批次首块以next链接其余块，压入全局池之前转存至存储区
+	static void push(Block* batch) noexcept
+	{
+		batch->successor() = batch->next.load(std::memory_order_relaxed);
+
+		auto& head = global().head;
+		TaggedPointer old_pointer = head.load(std::memory_order_relaxed);
+		TaggedPointer new_pointer;
+		do
+		{
+			batch->next.store(old_pointer.block, std::memory_order_relaxed);
+			new_pointer.block = batch;
+			new_pointer.tag = old_pointer.tag + 1;
+		} while (!head.compare_exchange_weak(old_pointer, new_pointer, \
+			std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	static Block* pop() noexcept
+	{
+		auto& head = global().head;
+		TaggedPointer old_pointer = head.load(std::memory_order_acquire);
+		TaggedPointer new_pointer;
+		do
+		{
+			if (old_pointer.block == nullptr)
+				return nullptr;
+			new_pointer.block = old_pointer.block->next.load(std::memory_order_relaxed);
+			new_pointer.tag = old_pointer.tag + 1;
+		} while (!head.compare_exchange_weak(old_pointer, new_pointer, \
+			std::memory_order_acquire, std::memory_order_acquire));
+
+		Block* batch = old_pointer.block;
+		batch->next.store(batch->successor(), std::memory_order_relaxed);
+		return batch;
+	}
+
+	// 申请一批新块，链接为链表
+	static Block* expand()
+	{
+		Block* chunk = new Block[BATCH];
+		for (size_t index = 0; index + 1 < BATCH; ++index)
+			chunk[index].next.store(chunk + index + 1, std::memory_order_relaxed);
+		chunk[BATCH - 1].next.store(nullptr, std::memory_order_relaxed);
+
+		auto& global = NodePool::global();
+		try
+		{
+			std::lock_guard<std::mutex> lock(global.mutex);
+			global.chunks.push_back(chunk);
+		}
+		catch (...)
+		{
+			delete[] chunk;
+			throw;
+		}
+		return chunk;
+	}
+
+	// 从全局池取回至少一批节点，全局池为空则申请新块
+	static void refill(Cache& cache)
+	{
+		while (cache.size < BATCH)
+		{
+			Block* batch = pop();
+			if (batch == nullptr)
+			{
+				if (cache.size > 0)
+					return;
+				batch = expand();
+			}
+
+			Block* tail = batch;
+			++cache.size;
+			for (Block* next; (next = tail->next.load(std::memory_order_relaxed)) != nullptr; tail = next)
+				++cache.size;
+			tail->next.store(cache.head, std::memory_order_relaxed);
+			cache.head = batch;
+		}
+	}
+
+public:
+	// 确保全局池先于使用者构造，从而后于使用者析构
+	static void initialize() { global(); }
+
+	static void* allocate()
+	{
+		auto& cache = NodePool::cache();
+		if (cache.head == nullptr)
+			refill(cache);
+
+		Block* block = cache.head;
+		cache.head = block->next.load(std::memory_order_relaxed);
+		--cache.size;
+		return block->storage;
+	}
+
+	static void deallocate(void* pointer) noexcept
+	{
+		auto& cache = NodePool::cache();
+		Block* block = reinterpret_cast<Block*>(pointer);
+		block->next.store(cache.head, std::memory_order_relaxed);
+		cache.head = block;
+
+		if (++cache.size < 2 * BATCH)
+			return;
+
+		// 保留一批，其余归还全局池
+		Block* tail = block;
+		for (size_t index = 1; index < BATCH; ++index)
+			tail = tail->next.load(std::memory_order_relaxed);
+		cache.head = tail->next.load(std::memory_order_relaxed);
+		tail->next.store(nullptr, std::memory_order_relaxed);
+		cache.size -= BATCH;
+		push(block);
+	}
+
+	// 直接归还全局池，不经线程缓存，适用于线程缓存可能已经销毁的场合，比如静态对象析构
+	static void reclaim(void* pointer) noexcept
+	{
+		Block* block = reinterpret_cast<Block*>(pointer);
+		block->next.store(nullptr, std::memory_order_relaxed);
+		push(block);
+	}
+};
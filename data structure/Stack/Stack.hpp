@@ -1,9 +1,19 @@
 #pragma once
 
+#include "NodePool.hpp"
+#include "EliminationArray.hpp"
+
 #include <cstddef>
+#include <utility>
+#include <new>
 #include <memory>
 #include <atomic>
 
+#if __cplusplus >= 201703L || defined(_MSVC_LANG) && _MSVC_LANG >= 201703L
+#include <optional>
+#define STACK_OPTIONAL
+#endif
+
 //template <typename Type>
 //class Stack
 //{
@@ -43,18 +53,45 @@ class Stack
 		Node* node;
 	};
 
+	// 数据直接存储于节点，入栈只分配一次内存
 	struct Node
 	{
-		std::shared_ptr<data_type> data;
+		data_type data;
 		std::atomic<size_type> internal;
 		counting_pointer next;
 
-		Node(const data_type& data)
-			: data(std::make_shared<data_type>(data)), internal(0) {}
+		template <typename... argument_types>
+		explicit Node(argument_types&&... arguments)
+			: data(std::forward<argument_types>(arguments)...), internal(0) {}
 	};
 
+	using pool_type = NodePool<Node>;
+
 	std::atomic<counting_pointer> head;
+	EliminationArray<Node> elimination;
 private:
+	// 节点经由节点池分配与回收，引用计数归零之后才回收，因此复用节点仍然安全
+	template <typename... argument_types>
+	static Node* create(argument_types&&... arguments)
+	{
+		void* pointer = pool_type::allocate();
+		try
+		{
+			return new (pointer) Node(std::forward<argument_types>(arguments)...);
+		}
+		catch (...)
+		{
+			pool_type::deallocate(pointer);
+			throw;
+		}
+	}
+
+	static void destroy(Node* node) noexcept
+	{
+		node->~Node();
+		pool_type::deallocate(node);
+	}
+
 	void increase(counting_pointer& old_pointer)
 	{
 		counting_pointer new_pointer;
@@ -66,42 +103,185 @@ private:
 			std::memory_order_acquire, std::memory_order_relaxed));
 		old_pointer.external = new_pointer.external;
 	}
+	// 摘除栈顶节点，以指定函数取走数据，栈为空则返回false
+	template <typename consumer_type>
+	bool take(consumer_type&& consume)
+	{
+		counting_pointer pointer = head.load(std::memory_order_relaxed);
+		while (true)
+		{
+			increase(pointer);
+			Node* const node = pointer.node;
+			if (node == nullptr)
+				return false;
+			if (head.compare_exchange_strong(pointer, node->next, std::memory_order_relaxed))
+			{
+				const size_type counter = pointer.external - 1;
+				try
+				{
+					consume(node->data);
+				}
+				catch (...)
+				{
+					release(node, counter);
+					throw;
+				}
+				release(node, counter);
+				return true;
+			}
+			else if (node->internal.fetch_sub(1, std::memory_order_relaxed) == 1)
+			{
+				node->internal.load(std::memory_order_acquire);
+				destroy(node);
+			}
+
+			// 竞争栈顶失败，尝试与入栈线程直接交换，交换的节点未曾入栈，无需引用计数
+			if (Node* exchanged = elimination.pop())
+			{
+				try
+				{
+					consume(exchanged->data);
+				}
+				catch (...)
+				{
+					destroy(exchanged);
+					throw;
+				}
+				destroy(exchanged);
+				return true;
+			}
+		}
+	}
+
+	void release(Node* node, size_type counter) noexcept
+	{
+		if (node->internal.fetch_add(counter, std::memory_order_release) == -counter)
+			destroy(node);
+	}
+
+	// 释放整条链表，每个节点的外部引用计数记录于前驱节点的链接
+	void discard(counting_pointer link) noexcept
+	{
+		while (link.node != nullptr)
+		{
+			counting_pointer next = link.node->next;
+			release(link.node, link.external);
+			link = next;
+		}
+	}
 public:
-	~Stack() { while (pop()); }
+	Stack() : head(counting_pointer{ 0, nullptr }) { pool_type::initialize(); }
 
-	void push(const data_type& data)
+	Stack(const Stack&) = delete;
+
+	// 析构无并发访问，直接归还全局池，以免静态对象析构之时线程缓存已经销毁
+	~Stack()
+	{
+		for (Node* node = head.load(std::memory_order_relaxed).node; node != nullptr;)
+		{
+			Node* next = node->next.node;
+			node->~Node();
+			pool_type::reclaim(node);
+			node = next;
+		}
+	}
+
+	Stack& operator=(const Stack&) = delete;
+
+	void push(const data_type& data) { emplace(data); }
+	void push(data_type&& data) { emplace(std::move(data)); }
+
+	template <typename... argument_types>
+	void emplace(argument_types&&... arguments)
 	{
 		counting_pointer pointer;
 		pointer.external = 0;
-		pointer.node = new Node(data);
+		pointer.node = create(std::forward<argument_types>(arguments)...);
 		pointer.node->next = head.load(std::memory_order_relaxed);
 		while (!head.compare_exchange_weak(pointer.node->next, pointer, \
+			std::memory_order_release, std::memory_order_relaxed))
+			if (elimination.push(pointer.node))
+				return;
+	}
+
+	// 预先链接区间的所有元素，再以一次比较和交换入栈，区间末尾的元素位于栈顶
+	template <typename input_iterator>
+	void push_range(input_iterator first, input_iterator last)
+	{
+		if (first == last)
+			return;
+
+		Node* bottom = create(*first);
+		bottom->next = counting_pointer{ 0, nullptr };
+		counting_pointer pointer{ 0, bottom };
+		try
+		{
+			for (++first; first != last; ++first)
+			{
+				Node* node = create(*first);
+				node->next = pointer;
+				pointer.node = node;
+			}
+		}
+		catch (...)
+		{
+			discard(pointer);
+			throw;
+		}
+
+		bottom->next = head.load(std::memory_order_relaxed);
+		while (!head.compare_exchange_weak(bottom->next, pointer, \
 			std::memory_order_release, std::memory_order_relaxed));
 	}
 
-	std::shared_ptr<data_type> pop()
+	// 以一次交换摘除所有节点，按照出栈顺序写入输出迭代器，返回写入之后的迭代器
+	template <typename output_iterator>
+	output_iterator pop_all(output_iterator iterator)
 	{
-		counting_pointer pointer = head.load(std::memory_order_relaxed);
-		while (true)
+		counting_pointer link = head.exchange(counting_pointer{ 0, nullptr }, \
+			std::memory_order_acquire);
+		while (link.node != nullptr)
 		{
-			increase(pointer);
-			Node* const node = pointer.node;
-			if (node == nullptr)
-				return std::shared_ptr<data_type>();
-			if (head.compare_exchange_strong(pointer, node->next, std::memory_order_relaxed))
+			Node* node = link.node;
+			counting_pointer next = node->next;
+			try
 			{
-				std::shared_ptr<data_type> data;
-				data.swap(node->data);
-				const size_type counter = pointer.external - 1;
-				if (node->internal.fetch_add(counter, std::memory_order_release) == -counter)
-					delete node;
-				return data;
+				*iterator++ = std::move(node->data);
 			}
-			else if (node->internal.fetch_sub(1, std::memory_order_relaxed) == 1)
+			catch (...)
 			{
-				node->internal.load(std::memory_order_acquire);
-				delete node;
+				release(node, link.external);
+				discard(next);
+				throw;
 			}
+
+			// 其他线程可能仍持有栈顶节点的引用，待其访问结束再回收
+			release(node, link.external);
+			link = next;
 		}
+		return iterator;
+	}
+
+	// 出栈至调用者提供的对象，栈为空则返回false
+	bool pop(data_type& data)
+	{
+		return take([&data](data_type& value) { data = std::move(value); });
+	}
+
+#ifdef STACK_OPTIONAL
+	std::optional<data_type> try_pop()
+	{
+		std::optional<data_type> data;
+		take([&data](data_type& value) { data.emplace(std::move(value)); });
+		return data;
+	}
+#endif
+
+	// 兼容接口，出栈数据需要另行分配共享指针
+	std::shared_ptr<data_type> pop()
+	{
+		std::shared_ptr<data_type> data;
+		take([&data](data_type& value) { data = std::make_shared<data_type>(std::move(value)); });
+		return data;
 	}
 };
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "WorkStealingDeque.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * 工作窃取线程池
+ * 每个工作线程拥有一个工作窃取双端队列，工作线程提交的任务放入自身队列，其他线程提交的任务放入注入队列。
+ * 工作线程依次从自身队列、注入队列取出任务，再随机选择其他工作线程窃取任务，皆无任务则休眠。
+ * 析构之时执行完所有已提交的任务，再结束工作线程。
+ * 任务抛出的异常由线程池捕获，记录最近一次的异常，不会终止工作线程。
+ */
+class ThreadPool
+{
+	using Task = std::function<void()>;
+
+	struct Worker
+	{
+		ThreadPool* pool;
+		WorkStealingDeque<Task*> deque;
+		std::thread thread;
+
+		explicit Worker(ThreadPool* pool) : pool(pool) {}
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers;
+
+	// 注入队列与休眠同步共用互斥元
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<Task*> injection;
+	bool running;
+	std::exception_ptr error;
+
+	// 已提交且尚未取出的任务数量，以及休眠的工作线程数量
+	std::atomic<size_t> pending;
+	std::atomic<size_t> idle;
+
+private:
+	static Worker*& current() noexcept
+	{
+		thread_local Worker* worker = nullptr;
+		return worker;
+	}
+
+	bool take(Worker& worker, Task*& task);
+
+	void execute(Worker& worker);
+
+	void enqueue(Task* task);
+
+public:
+	explicit ThreadPool(size_t size = std::thread::hardware_concurrency());
+
+	ThreadPool(const ThreadPool&) = delete;
+
+	~ThreadPool();
+
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	size_t size() const noexcept { return workers.size(); }
+
+	// 取出任务最近一次抛出的异常，若无异常则返回空指针
+	std::exception_ptr exception()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::exception_ptr result = error;
+		error = nullptr;
+		return result;
+	}
+
+	template <typename function_type>
+	void submit(function_type&& function)
+	{
+		std::unique_ptr<Task> task(new Task(std::forward<function_type>(function)));
+		enqueue(task.get());
+		task.release();
+	}
+};
+
+inline ThreadPool::ThreadPool(size_t size)
+	: running(true), pending(0), idle(0)
+{
+	if (size <= 0)
+		size = 1;
+
+	workers.reserve(size);
+	for (size_t index = 0; index < size; ++index)
+		workers.emplace_back(new Worker(this));
+
+	try
+	{
+		for (auto& worker : workers)
+			worker->thread = std::thread(&ThreadPool::execute, this, std::ref(*worker));
+	}
+	catch (...)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			running = false;
+		}
+		condition.notify_all();
+		for (auto& worker : workers)
+			if (worker->thread.joinable())
+				worker->thread.join();
+		throw;
+	}
+}
+
+inline ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		running = false;
+	}
+	condition.notify_all();
+
+	for (auto& worker : workers)
+		if (worker->thread.joinable())
+			worker->thread.join();
+}
+
+inline bool ThreadPool::take(Worker& worker, Task*& task)
+{
+	if (worker.deque.pop(task))
+		return true;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!injection.empty())
+		{
+			task = injection.front();
+			injection.pop_front();
+			return true;
+		}
+	}
+
+	// 从随机位置开始遍历其他工作线程
+	static thread_local std::uint32_t seed = \
+		static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&worker)) | 1;
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+
+	size_t size = workers.size();
+	for (size_t offset = 0, start = seed % size; offset < size; ++offset)
+	{
+		Worker& victim = *workers[(start + offset) % size];
+		if (&victim != &worker && victim.deque.steal(task))
+			return true;
+	}
+	return false;
+}
+
+inline void ThreadPool::execute(Worker& worker)
+{
+	current() = &worker;
+	while (true)
+	{
+		Task* task = nullptr;
+		if (take(worker, task))
+		{
+			pending.fetch_sub(1);
+			std::unique_ptr<Task> guard(task);
+			try
+			{
+				(*task)();
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				error = std::current_exception();
+			}
+			continue;
+		}
+
+		// 窃取失败可能只是竞争所致，仍有待取任务则重试
+		std::unique_lock<std::mutex> lock(mutex);
+		idle.fetch_add(1);
+		while (pending.load() <= 0 && running)
+			condition.wait(lock);
+		idle.fetch_sub(1);
+
+		if (pending.load() <= 0 && !running)
+			break;
+	}
+	current() = nullptr;
+}
+
+inline void ThreadPool::enqueue(Task* task)
+{
+	// 先增加任务数量再放入任务，取出任务之后才减少，数量不会下溢
+	pending.fetch_add(1);
+
+	try
+	{
+		Worker* worker = current();
+		if (worker != nullptr && worker->pool == this)
+			worker->deque.push(task);
+		else
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			injection.push_back(task);
+		}
+	}
+	catch (...)
+	{
+		// 放入失败则撤销任务数量，否则工作线程将持续自旋，析构亦无法结束
+		pending.fetch_sub(1);
+		throw;
+	}
+
+	// 先增加任务数量再检查休眠数量，与休眠线程的顺序相反，确保至少一方观察到另一方
+	if (idle.load() > 0)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		condition.notify_one();
+	}
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/*
+ * Chase-Lev工作窃取双端队列
+ * 所有者线程在底部入队和出队，后进先出；其他线程从顶部窃取，先进先出。
+ * 所有者与窃取者只在仅剩一个元素之时竞争，以一次比较和交换裁决。
+ * 环形数组写满则容量翻倍，旧数组可能仍被窃取者读取，因此保留至队列析构。
+ * 元素以原子变量存储，要求可平凡复制，通常存储任务指针。
+ */
+template <typename value_type>
+class WorkStealingDeque
+{
+	static_assert(std::is_trivially_copyable<value_type>::value, \
+		"The value type of a work-stealing deque must be trivially copyable.");
+
+	using index_type = std::int64_t;
+
+	struct Array
+	{
+		index_type capacity;
+		std::unique_ptr<std::atomic<value_type>[]> buffer;
+
+		explicit Array(index_type capacity)
+			: capacity(capacity), buffer(new std::atomic<value_type>[capacity]) {}
+
+		value_type get(index_type index) const noexcept
+		{
+			return buffer[index & (capacity - 1)].load(std::memory_order_relaxed);
+		}
+
+		void put(index_type index, value_type value) noexcept
+		{
+			buffer[index & (capacity - 1)].store(value, std::memory_order_relaxed);
+		}
+	};
+
+	std::atomic<index_type> top;
+	std::atomic<index_type> bottom;
+	std::atomic<Array*> array;
+	std::vector<std::unique_ptr<Array>> arrays;
+
+private:
+	// 仅由所有者线程调用
+	Array* grow(Array* old_array, index_type top, index_type bottom)
+	{
+		std::unique_ptr<Array> new_array(new Array(old_array->capacity * 2));
+		for (index_type index = top; index < bottom; ++index)
+			new_array->put(index, old_array->get(index));
+
+		arrays.push_back(std::move(new_array));
+		Array* result = arrays.back().get();
+		array.store(result, std::memory_order_release);
+		return result;
+	}
+
+public:
+	// 初始容量向上取整为2的幂
+	explicit WorkStealingDeque(size_t capacity = 64)
+		: top(0), bottom(0), array(nullptr)
+	{
+		index_type size = 1;
+		while (size < static_cast<index_type>(capacity))
+			size *= 2;
+
+		arrays.emplace_back(new Array(size));
+		array.store(arrays.back().get(), std::memory_order_relaxed);
+	}
+
+	WorkStealingDeque(const WorkStealingDeque&) = delete;
+
+	WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+	bool empty() const noexcept
+	{
+		return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+	}
+
+	size_t size() const noexcept
+	{
+		index_type size = bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_relaxed);
+		return size > 0 ? static_cast<size_t>(size) : 0;
+	}
+
+	// 所有者线程入队
+	void push(value_type value)
+	{
+		index_type bottom = this->bottom.load(std::memory_order_relaxed);
+		index_type top = this->top.load(std::memory_order_acquire);
+		Array* array = this->array.load(std::memory_order_relaxed);
+		if (bottom - top > array->capacity - 1)
+			array = grow(array, top, bottom);
+
+		array->put(bottom, value);
+		this->bottom.store(bottom + 1, std::memory_order_release);
+	}
+
+	// 所有者线程出队，后进先出，队列为空则返回false
+	bool pop(value_type& value) noexcept
+	{
+		index_type bottom = this->bottom.load(std::memory_order_relaxed) - 1;
+		Array* array = this->array.load(std::memory_order_relaxed);
+		this->bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		index_type top = this->top.load(std::memory_order_relaxed);
+
+		if (top > bottom)
+		{
+			this->bottom.store(bottom + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		value = array->get(bottom);
+		if (top < bottom)
+			return true;
+
+		// 仅剩一个元素，与窃取者竞争
+		bool result = this->top.compare_exchange_strong(top, top + 1, \
+			std::memory_order_seq_cst, std::memory_order_relaxed);
+		this->bottom.store(bottom + 1, std::memory_order_relaxed);
+		return result;
+	}
+
+	// 其他线程窃取，先进先出，队列为空或者竞争失败则返回false
+	bool steal(value_type& value) noexcept
+	{
+		index_type top = this->top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		index_type bottom = this->bottom.load(std::memory_order_acquire);
+		if (top >= bottom)
+			return false;
+
+		Array* array = this->array.load(std::memory_order_acquire);
+		value_type result = array->get(top);
+		if (!this->top.compare_exchange_strong(top, top + 1, \
+			std::memory_order_seq_cst, std::memory_order_relaxed))
+			return false;
+
+		value = result;
+		return true;
+	}
+};
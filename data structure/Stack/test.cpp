@@ -1,4 +1,5 @@
 #include "Stack.hpp"
+#include "HazardStack.hpp"
 
 #include <chrono>
 #include <cstddef>
@@ -8,8 +9,18 @@
 #include <fstream>
 #include <thread>
 
-Stack<int> stack;
-Stack<int> stream;
+//#define HAZARD
+
+#ifndef HAZARD
+template <typename data_type>
+using StackType = Stack<data_type>;
+#else // HAZARD
+template <typename data_type>
+using StackType = HazardStack<data_type>;
+#endif // !HAZARD
+
+StackType<int> stack;
+StackType<int> stream;
 
 static constexpr size_t THREADS = 10;
 static constexpr size_t NUMBERS = 100;
@@ -27,7 +38,7 @@ static void execute(size_t start, size_t stop)
 
 static void lock_free()
 {
-	std::shared_ptr<Stack<int>> shared_pointer;
+	std::shared_ptr<StackType<int>> shared_pointer;
 	std::cout << std::boolalpha << std::atomic_is_lock_free(&shared_pointer) << std::endl;
 }
 
@@ -5,6 +5,7 @@
 #include <iostream>
 
 #define SHARED
+//#define B_PLUS_TREE
 
 struct Record
 {
@@ -38,18 +39,30 @@ bool Record::operator<(const Record& _record) const noexcept
 
 using SizeType = Record::SizeType;
 
+#ifndef B_PLUS_TREE
 #ifndef SHARED
 using SorterType = Sorter<SizeType, Record>;
 #else // SHARED
 using SorterType = SharedSorter<SizeType, Record>;
 #endif // !SHARED
 
+#else // B_PLUS_TREE
+#ifndef SHARED
+using SorterType = Sorter<SizeType, Record, BPlusTree>;
+#else // SHARED
+using SorterType = SharedSorter<SizeType, Record, BPlusTree>;
+#endif // !SHARED
+#endif // !B_PLUS_TREE
+
 static constexpr SizeType SIZE = 100 + 1;
 
 static void load(SorterType& _sorter)
 {
+	SorterType::RecordList recordList;
+	recordList.reserve(SIZE - 1);
 	for (SizeType index = 1; index < SIZE; ++index)
-		_sorter.update({ index, SIZE - index, index });
+		recordList.push_back({ index, SIZE - index, index });
+	_sorter.update(recordList);
 }
 
 static void update(SorterType& _sorter)
@@ -0,0 +1,850 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/*
+ * B+树
+ * 元素按序存储于叶节点的连续数组，叶节点双向链接，顺序遍历只需依次扫描数组，缓存友好。
+ * 内部节点记录每棵子树的元素数量，按照次序查找元素与计算元素的次序都只需对数时间。
+ * 内部节点不复制元素作为分隔键，而是记录每棵子树的最左叶节点，以其首元素比较，因此元素的共享状态被修改也不会与分隔键不一致。
+ * 除根节点之外，节点的元素或者子节点数量不少于容量的四分之一，不足则与兄弟节点合并或者重新分配。
+ * 接口与顺序统计树保持一致，插入与移除使迭代器失效。
+ */
+template <typename _Type, typename _Compare = std::less<_Type>>
+class BPlusTree
+{
+	struct Node;
+	struct Leaf;
+	struct Internal;
+
+public:
+	using ValueType = _Type;
+	using SizeType = std::size_t;
+
+	using value_type = ValueType;
+	using size_type = SizeType;
+
+	class Iterator;
+
+	using iterator = Iterator;
+	using const_iterator = Iterator;
+	using reverse_iterator = std::reverse_iterator<Iterator>;
+	using const_reverse_iterator = reverse_iterator;
+
+private:
+	static constexpr SizeType LEAF_CAPACITY = 64;
+	static constexpr SizeType INTERNAL_CAPACITY = 64;
+
+	static constexpr SizeType LEAF_MIN = LEAF_CAPACITY / 4;
+	static constexpr SizeType INTERNAL_MIN = INTERNAL_CAPACITY / 4;
+
+private:
+	Node* _root;
+	Leaf* _head;
+	Leaf* _tail;
+	SizeType _size;
+	_Compare _compare;
+
+private:
+	static SizeType position(const Internal* _parent, const Node* _child) noexcept
+	{
+		auto& children = _parent->_children;
+		return std::find(children.begin(), children.end(), _child) - children.begin();
+	}
+
+	static const Leaf* leftmost(const Node* _node) noexcept
+	{
+		return _node->_leaf ? static_cast<const Leaf*>(_node) \
+			: static_cast<const Internal*>(_node)->_leaves.front();
+	}
+
+	static SizeType count(const Node* _node) noexcept;
+
+	static void destroy(Node* _node) noexcept;
+
+	// 自叶节点向上调整子树的元素数量
+	static void adjust(Node* _node, bool _increase) noexcept;
+
+	// 查找元素所在的叶节点
+	const Leaf* descend(const ValueType& _value) const;
+
+	// 从有序且不重复的区间批量构建，要求树为空
+	template <typename _Iterator>
+	void load(_Iterator _first, _Iterator _last);
+
+	// 节点分裂之后，将右节点插入父节点
+	void link(Node* _left, Node* _right, SizeType _count);
+
+	void split(Leaf* _leaf);
+
+	void split(Internal* _internal);
+
+	// 元素不足则与兄弟节点合并或者重新分配
+	void rebalance(Leaf* _leaf);
+
+	void rebalance(Internal* _internal);
+
+public:
+	BPlusTree() noexcept : \
+		_root(nullptr), _head(nullptr), _tail(nullptr), _size(0) {}
+
+	BPlusTree(const BPlusTree& _another) : \
+		BPlusTree()
+	{
+		_compare = _another._compare;
+		load(_another.begin(), _another.end());
+	}
+
+	BPlusTree(BPlusTree&& _another) noexcept : \
+		BPlusTree()
+	{
+		swap(_another);
+	}
+
+	~BPlusTree() noexcept
+	{
+		destroy(_root);
+	}
+
+	BPlusTree& operator=(const BPlusTree& _tree)
+	{
+		if (&_tree != this)
+		{
+			BPlusTree tree(_tree);
+			swap(tree);
+		}
+		return *this;
+	}
+
+	BPlusTree& operator=(BPlusTree&& _tree) noexcept
+	{
+		if (&_tree != this)
+		{
+			clear();
+			swap(_tree);
+		}
+		return *this;
+	}
+
+	void swap(BPlusTree& _tree) noexcept
+	{
+		using std::swap;
+		swap(_root, _tree._root);
+		swap(_head, _tree._head);
+		swap(_tail, _tree._tail);
+		swap(_size, _tree._size);
+		swap(_compare, _tree._compare);
+	}
+
+	bool empty() const noexcept
+	{
+		return _size <= 0;
+	}
+
+	SizeType size() const noexcept
+	{
+		return _size;
+	}
+
+	void clear() noexcept
+	{
+		destroy(_root);
+		_root = nullptr;
+		_head = _tail = nullptr;
+		_size = 0;
+	}
+
+	Iterator begin() const noexcept
+	{
+		return Iterator(this, _head, 0);
+	}
+
+	Iterator end() const noexcept
+	{
+		return Iterator(this, nullptr, 0);
+	}
+
+	Iterator cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	Iterator cend() const noexcept
+	{
+		return end();
+	}
+
+	reverse_iterator rbegin() const noexcept
+	{
+		return reverse_iterator(end());
+	}
+
+	reverse_iterator rend() const noexcept
+	{
+		return reverse_iterator(begin());
+	}
+
+	reverse_iterator crbegin() const noexcept
+	{
+		return rbegin();
+	}
+
+	reverse_iterator crend() const noexcept
+	{
+		return rend();
+	}
+
+	// 从有序且不重复的区间批量构建，替换原有元素，叶节点依次填充，只需线性时间
+	template <typename _Iterator>
+	void assign(_Iterator _first, _Iterator _last)
+	{
+		clear();
+		load(_first, _last);
+	}
+
+	// 查找等价元素，若无则返回尾迭代器
+	Iterator find(const ValueType& _value) const;
+
+	// 插入元素，倘若存在等价元素，则不插入并且返回其迭代器
+	std::pair<Iterator, bool> insert(const ValueType& _value)
+	{
+		return emplace(_value);
+	}
+
+	std::pair<Iterator, bool> insert(ValueType&& _value)
+	{
+		return emplace(std::move(_value));
+	}
+
+	template <typename _Value>
+	std::pair<Iterator, bool> emplace(_Value&& _value);
+
+	/*
+	 * 以指定函数修改元素，倘若次序不变，则原地修改，否则移除之后重新插入
+	 * 倘若修改之后存在等价元素，则移除元素并且返回等价元素的迭代器。
+	 */
+	template <typename _Function>
+	std::pair<Iterator, bool> modify(Iterator _position, _Function&& _function);
+
+	// 以新元素替换指定元素
+	std::pair<Iterator, bool> replace(Iterator _position, const ValueType& _value)
+	{
+		return modify(_position, [&_value](ValueType& _element)
+			{
+				_element = _value;
+			});
+	}
+
+	// 移除指定元素，返回后继元素的迭代器
+	Iterator erase(Iterator _position);
+
+	// 移除等价元素，返回移除数量
+	SizeType erase(const ValueType& _value);
+
+	// 获取元素的次序，从零开始计数，尾迭代器的次序为元素数量
+	SizeType rank(Iterator _position) const noexcept;
+
+	// 获取指定次序的元素，越界则返回尾迭代器
+	Iterator select(SizeType _index) const noexcept;
+};
+
+template <typename _Type, typename _Compare>
+struct BPlusTree<_Type, _Compare>::Node
+{
+	Internal* _parent;
+	bool _leaf;
+
+	explicit Node(bool _leaf) noexcept : \
+		_parent(nullptr), _leaf(_leaf) {}
+};
+
+template <typename _Type, typename _Compare>
+struct BPlusTree<_Type, _Compare>::Leaf : Node
+{
+	std::vector<ValueType> _values;
+	Leaf* _previous;
+	Leaf* _next;
+
+	Leaf() : Node(true), \
+		_previous(nullptr), _next(nullptr)
+	{
+		_values.reserve(LEAF_CAPACITY + 1);
+	}
+};
+
+// 子节点、子树元素数量与子树最左叶节点一一对应
+template <typename _Type, typename _Compare>
+struct BPlusTree<_Type, _Compare>::Internal : Node
+{
+	std::vector<Node*> _children;
+	std::vector<SizeType> _counts;
+	std::vector<const Leaf*> _leaves;
+
+	Internal() : Node(false)
+	{
+		_children.reserve(INTERNAL_CAPACITY + 1);
+		_counts.reserve(INTERNAL_CAPACITY + 1);
+		_leaves.reserve(INTERNAL_CAPACITY + 1);
+	}
+};
+
+template <typename _Type, typename _Compare>
+class BPlusTree<_Type, _Compare>::Iterator
+{
+	friend class BPlusTree;
+
+public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = ValueType;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const ValueType*;
+	using reference = const ValueType&;
+
+private:
+	const BPlusTree* _tree;
+	const Leaf* _leaf;
+	SizeType _index;
+
+private:
+	Iterator(const BPlusTree* _tree, const Leaf* _leaf, SizeType _index) noexcept : \
+		_tree(_tree), _leaf(_leaf), _index(_index) {}
+
+public:
+	Iterator() noexcept : \
+		_tree(nullptr), _leaf(nullptr), _index(0) {}
+
+	reference operator*() const noexcept
+	{
+		return _leaf->_values[_index];
+	}
+
+	pointer operator->() const noexcept
+	{
+		return &_leaf->_values[_index];
+	}
+
+	Iterator& operator++() noexcept
+	{
+		if (++_index >= _leaf->_values.size())
+		{
+			_leaf = _leaf->_next;
+			_index = 0;
+		}
+		return *this;
+	}
+
+	Iterator operator++(int) noexcept
+	{
+		auto iterator = *this;
+		++*this;
+		return iterator;
+	}
+
+	// 尾迭代器递减则指向最大元素
+	Iterator& operator--() noexcept
+	{
+		if (_leaf == nullptr || _index <= 0)
+		{
+			_leaf = _leaf != nullptr ? _leaf->_previous : _tree->_tail;
+			_index = _leaf->_values.size();
+		}
+		--_index;
+		return *this;
+	}
+
+	Iterator operator--(int) noexcept
+	{
+		auto iterator = *this;
+		--*this;
+		return iterator;
+	}
+
+	bool operator==(const Iterator& _iterator) const noexcept
+	{
+		return _leaf == _iterator._leaf && _index == _iterator._index;
+	}
+};
+
+template <typename _Type, typename _Compare>
+auto BPlusTree<_Type, _Compare>::count(const Node* _node) noexcept \
+-> SizeType
+{
+	if (_node->_leaf)
+		return static_cast<const Leaf*>(_node)->_values.size();
+
+	auto& counts = static_cast<const Internal*>(_node)->_counts;
+	SizeType result = 0;
+	for (auto count : counts)
+		result += count;
+	return result;
+}
+
+template <typename _Type, typename _Compare>
+void BPlusTree<_Type, _Compare>::destroy(Node* _node) noexcept
+{
+	if (_node == nullptr) return;
+
+	if (_node->_leaf)
+	{
+		delete static_cast<Leaf*>(_node);
+		return;
+	}
+
+	auto internal = static_cast<Internal*>(_node);
+	for (auto child : internal->_children)
+		destroy(child);
+	delete internal;
+}
+
+template <typename _Type, typename _Compare>
+void BPlusTree<_Type, _Compare>::adjust(Node* _node, bool _increase) noexcept
+{
+	for (auto parent = _node->_parent; parent != nullptr; \
+		_node = parent, parent = parent->_parent)
+	{
+		auto& count = parent->_counts[position(parent, _node)];
+		if (_increase) ++count;
+		else --count;
+	}
+}
+
+// 在内部节点中，以子树最左叶节点的首元素二分查找子树
+template <typename _Type, typename _Compare>
+auto BPlusTree<_Type, _Compare>::descend(const ValueType& _value) const \
+-> const Leaf*
+{
+	const Node* node = _root;
+	while (!node->_leaf)
+	{
+		auto& leaves = static_cast<const Internal*>(node)->_leaves;
+		auto iterator = std::upper_bound(leaves.begin() + 1, leaves.end(), _value, \
+			[this](const ValueType& _value, const Leaf* _leaf)
+			{
+				return _compare(_value, _leaf->_values.front());
+			});
+		node = static_cast<const Internal*>(node)->_children[iterator - leaves.begin() - 1];
+	}
+	return static_cast<const Leaf*>(node);
+}
+
+// 节点均匀填充至容量的四分之三，为后续插入预留空间
+template <typename _Type, typename _Compare>
+template <typename _Iterator>
+void BPlusTree<_Type, _Compare>::load(_Iterator _first, _Iterator _last)
+{
+	auto distribute = [](SizeType _total, SizeType _capacity)
+	{
+		auto fill = _capacity - _capacity / 4;
+		auto number = (_total + fill - 1) / fill;
+		return number > 0 ? number : 1;
+	};
+
+	auto total = static_cast<SizeType>(std::distance(_first, _last));
+	if (total <= 0) return;
+
+	// 每层节点在挂接至父节点之前，以其父节点指针为空标识
+	std::vector<Node*> level, parents;
+	try
+	{
+		auto number = distribute(total, LEAF_CAPACITY);
+		level.reserve(number);
+		for (SizeType index = 0; index < number; ++index)
+		{
+			auto leaf = new Leaf;
+			level.push_back(leaf);
+
+			leaf->_previous = _tail;
+			if (_tail != nullptr) _tail->_next = leaf;
+			else _head = leaf;
+			_tail = leaf;
+
+			auto size = total / number + (index < total % number ? 1 : 0);
+			for (; size > 0; --size, ++_first)
+				leaf->_values.push_back(*_first);
+			_size += leaf->_values.size();
+		}
+
+		while (level.size() > 1)
+		{
+			number = distribute(level.size(), INTERNAL_CAPACITY);
+			parents.reserve(number);
+
+			auto child = level.begin();
+			for (SizeType index = 0; index < number; ++index)
+			{
+				auto internal = new Internal;
+				parents.push_back(internal);
+
+				auto size = level.size() / number + (index < level.size() % number ? 1 : 0);
+				for (; size > 0; --size, ++child)
+				{
+					(*child)->_parent = internal;
+					internal->_children.push_back(*child);
+					internal->_counts.push_back(count(*child));
+					internal->_leaves.push_back(leftmost(*child));
+				}
+			}
+
+			level.swap(parents);
+			parents.clear();
+		}
+		_root = level.front();
+	}
+	catch (...)
+	{
+		for (auto node : level)
+			if (node->_parent == nullptr)
+				destroy(node);
+		for (auto node : parents)
+			destroy(node);
+
+		_head = _tail = nullptr;
+		_size = 0;
+		throw;
+	}
+}
+
+template <typename _Type, typename _Compare>
+void BPlusTree<_Type, _Compare>::link(Node* _left, Node* _right, SizeType _count)
+{
+	auto parent = _left->_parent;
+	if (parent == nullptr)
+	{
+		auto root = new Internal;
+		root->_children = { _left, _right };
+		root->_counts = { count(_left), _count };
+		root->_leaves = { leftmost(_left), leftmost(_right) };
+		_left->_parent = _right->_parent = root;
+		_root = root;
+		return;
+	}
+
+	auto index = position(parent, _left);
+	parent->_counts[index] -= _count;
+	parent->_children.insert(parent->_children.begin() + index + 1, _right);
+	parent->_counts.insert(parent->_counts.begin() + index + 1, _count);
+	parent->_leaves.insert(parent->_leaves.begin() + index + 1, leftmost(_right));
+	_right->_parent = parent;
+
+	if (parent->_children.size() > INTERNAL_CAPACITY)
+		split(parent);
+}
+
+template <typename _Type, typename _Compare>
+void BPlusTree<_Type, _Compare>::split(Leaf* _leaf)
+{
+	auto leaf = new Leaf;
+	auto middle = _leaf->_values.begin() + _leaf->_values.size() / 2;
+	leaf->_values.assign(std::make_move_iterator(middle), \
+		std::make_move_iterator(_leaf->_values.end()));
+	_leaf->_values.erase(middle, _leaf->_values.end());
+
+	leaf->_previous = _leaf;
+	leaf->_next = _leaf->_next;
+	if (_leaf->_next != nullptr) _leaf->_next->_previous = leaf;
+	else _tail = leaf;
+	_leaf->_next = leaf;
+
+	link(_leaf, leaf, leaf->_values.size());
+}
+
+template <typename _Type, typename _Compare>
+void BPlusTree<_Type, _Compare>::split(Internal* _internal)
+{
+	auto internal = new Internal;
+	auto middle = _internal->_children.size() / 2;
+	internal->_children.assign(_internal->_children.begin() + middle, _internal->_children.end());
+	internal->_counts.assign(_internal->_counts.begin() + middle, _internal->_counts.end());
+	internal->_leaves.assign(_internal->_leaves.begin() + middle, _internal->_leaves.end());
+	_internal->_children.resize(middle);
+	_internal->_counts.resize(middle);
+	_internal->_leaves.resize(middle);
+
+	for (auto child : internal->_children)
+		child->_parent = internal;
+
+	link(_internal, internal, count(internal));
+}
+
+// 总是移除右节点，因此任何子树的最左叶节点保持不变
+template <typename _Type, typename _Compare>
+void BPlusTree<_Type, _Compare>::rebalance(Leaf* _leaf)
+{
+	auto parent = _leaf->_parent;
+	if (parent == nullptr)
+	{
+		if (_leaf->_values.empty())
+			clear();
+		return;
+	}
+
+	if (_leaf->_values.size() >= LEAF_MIN) return;
+
+	auto index = position(parent, _leaf);
+	if (index + 1 >= parent->_children.size()) --index;
+
+	auto left = static_cast<Leaf*>(parent->_children[index]);
+	auto right = static_cast<Leaf*>(parent->_children[index + 1]);
+	auto& leftValues = left->_values;
+	auto& rightValues = right->_values;
+
+	if (leftValues.size() + rightValues.size() <= LEAF_CAPACITY)
+	{
+		leftValues.insert(leftValues.end(), std::make_move_iterator(rightValues.begin()), \
+			std::make_move_iterator(rightValues.end()));
+
+		left->_next = right->_next;
+		if (right->_next != nullptr) right->_next->_previous = left;
+		else _tail = left;
+
+		parent->_counts[index] += parent->_counts[index + 1];
+		parent->_children.erase(parent->_children.begin() + index + 1);
+		parent->_counts.erase(parent->_counts.begin() + index + 1);
+		parent->_leaves.erase(parent->_leaves.begin() + index + 1);
+		delete right;
+
+		rebalance(parent);
+		return;
+	}
+
+	auto total = leftValues.size() + rightValues.size();
+	if (leftValues.size() < total / 2)
+	{
+		auto size = total / 2 - leftValues.size();
+		leftValues.insert(leftValues.end(), std::make_move_iterator(rightValues.begin()), \
+			std::make_move_iterator(rightValues.begin() + size));
+		rightValues.erase(rightValues.begin(), rightValues.begin() + size);
+	}
+	else
+	{
+		auto size = leftValues.size() - total / 2;
+		rightValues.insert(rightValues.begin(), std::make_move_iterator(leftValues.end() - size), \
+			std::make_move_iterator(leftValues.end()));
+		leftValues.erase(leftValues.end() - size, leftValues.end());
+	}
+	parent->_counts[index] = leftValues.size();
+	parent->_counts[index + 1] = rightValues.size();
+}
+
+template <typename _Type, typename _Compare>
+void BPlusTree<_Type, _Compare>::rebalance(Internal* _internal)
+{
+	auto parent = _internal->_parent;
+	if (parent == nullptr)
+	{
+		// 根节点只剩一个子节点则降低树高
+		if (_internal->_children.size() == 1)
+		{
+			_root = _internal->_children.front();
+			_root->_parent = nullptr;
+			delete _internal;
+		}
+		return;
+	}
+
+	if (_internal->_children.size() >= INTERNAL_MIN) return;
+
+	auto index = position(parent, _internal);
+	if (index + 1 >= parent->_children.size()) --index;
+
+	auto left = static_cast<Internal*>(parent->_children[index]);
+	auto right = static_cast<Internal*>(parent->_children[index + 1]);
+
+	auto move = [](Internal* _target, typename std::vector<Node*>::iterator _position, \
+		Internal* _source, SizeType _first, SizeType _last)
+	{
+		auto offset = _position - _target->_children.begin();
+		_target->_children.insert(_position, _source->_children.begin() + _first, \
+			_source->_children.begin() + _last);
+		_target->_counts.insert(_target->_counts.begin() + offset, \
+			_source->_counts.begin() + _first, _source->_counts.begin() + _last);
+		_target->_leaves.insert(_target->_leaves.begin() + offset, \
+			_source->_leaves.begin() + _first, _source->_leaves.begin() + _last);
+		for (auto index = _first; index < _last; ++index)
+			_source->_children[index]->_parent = _target;
+
+		_source->_children.erase(_source->_children.begin() + _first, _source->_children.begin() + _last);
+		_source->_counts.erase(_source->_counts.begin() + _first, _source->_counts.begin() + _last);
+		_source->_leaves.erase(_source->_leaves.begin() + _first, _source->_leaves.begin() + _last);
+	};
+
+	auto total = left->_children.size() + right->_children.size();
+	if (total <= INTERNAL_CAPACITY)
+	{
+		move(left, left->_children.end(), right, 0, right->_children.size());
+
+		parent->_counts[index] += parent->_counts[index + 1];
+		parent->_children.erase(parent->_children.begin() + index + 1);
+		parent->_counts.erase(parent->_counts.begin() + index + 1);
+		parent->_leaves.erase(parent->_leaves.begin() + index + 1);
+		delete right;
+
+		rebalance(parent);
+		return;
+	}
+
+	if (left->_children.size() < total / 2)
+		move(left, left->_children.end(), right, \
+			0, total / 2 - left->_children.size());
+	else
+		move(right, right->_children.begin(), left, \
+			total / 2, left->_children.size());
+
+	parent->_counts[index] = count(left);
+	parent->_counts[index + 1] = count(right);
+	parent->_leaves[index + 1] = right->_leaves.front();
+}
+
+// 查找等价元素
+template <typename _Type, typename _Compare>
+auto BPlusTree<_Type, _Compare>::find(const ValueType& _value) const \
+-> Iterator
+{
+	if (empty()) return end();
+
+	auto leaf = descend(_value);
+	auto& values = leaf->_values;
+	auto iterator = std::lower_bound(values.begin(), values.end(), _value, _compare);
+	if (iterator == values.end() || _compare(_value, *iterator))
+		return end();
+	return Iterator(this, leaf, iterator - values.begin());
+}
+
+// 插入元素
+template <typename _Type, typename _Compare>
+template <typename _Value>
+auto BPlusTree<_Type, _Compare>::emplace(_Value&& _value) \
+-> std::pair<Iterator, bool>
+{
+	if (_root == nullptr)
+	{
+		auto leaf = new Leaf;
+		_root = _head = _tail = leaf;
+	}
+
+	auto leaf = const_cast<Leaf*>(descend(_value));
+	auto& values = leaf->_values;
+	auto iterator = std::lower_bound(values.begin(), values.end(), _value, _compare);
+	if (iterator != values.end() && !_compare(_value, *iterator))
+		return std::make_pair(Iterator(this, leaf, iterator - values.begin()), false);
+
+	auto index = static_cast<SizeType>(iterator - values.begin());
+	try
+	{
+		values.insert(iterator, std::forward<_Value>(_value));
+	}
+	catch (...)
+	{
+		if (_size <= 0) clear();
+		throw;
+	}
+	++_size;
+	adjust(leaf, true);
+
+	if (values.size() <= LEAF_CAPACITY)
+		return std::make_pair(Iterator(this, leaf, index), true);
+
+	split(leaf);
+	if (index >= leaf->_values.size())
+		return std::make_pair(Iterator(this, leaf->_next, index - leaf->_values.size()), true);
+	return std::make_pair(Iterator(this, leaf, index), true);
+}
+
+// 修改元素
+template <typename _Type, typename _Compare>
+template <typename _Function>
+auto BPlusTree<_Type, _Compare>::modify(Iterator _position, \
+	_Function&& _function) -> std::pair<Iterator, bool>
+{
+	auto leaf = const_cast<Leaf*>(_position._leaf);
+	auto& value = leaf->_values[_position._index];
+	try
+	{
+		_function(value);
+	}
+	catch (...)
+	{
+		erase(_position);
+		throw;
+	}
+
+	// 与前驱和后继比较，次序不变则无需移动元素
+	auto previous = _position, next = _position;
+	if ((_position == begin() || _compare(*--previous, value)) \
+		&& (++next == end() || _compare(value, *next)))
+		return std::make_pair(_position, true);
+
+	auto element = std::move(value);
+	erase(_position);
+	return emplace(std::move(element));
+}
+
+// 移除指定元素
+template <typename _Type, typename _Compare>
+auto BPlusTree<_Type, _Compare>::erase(Iterator _position) \
+-> Iterator
+{
+	auto leaf = const_cast<Leaf*>(_position._leaf);
+	auto index = rank(_position);
+
+	leaf->_values.erase(leaf->_values.begin() + _position._index);
+	--_size;
+	adjust(leaf, false);
+	rebalance(leaf);
+	return select(index);
+}
+
+// 移除等价元素
+template <typename _Type, typename _Compare>
+auto BPlusTree<_Type, _Compare>::erase(const ValueType& _value) \
+-> SizeType
+{
+	auto iterator = find(_value);
+	if (iterator == end()) return 0;
+
+	erase(iterator);
+	return 1;
+}
+
+// 获取元素的次序
+template <typename _Type, typename _Compare>
+auto BPlusTree<_Type, _Compare>::rank(Iterator _position) const noexcept \
+-> SizeType
+{
+	if (_position._leaf == nullptr) return size();
+
+	auto index = _position._index;
+	const Node* node = _position._leaf;
+	for (auto parent = node->_parent; parent != nullptr; \
+		node = parent, parent = parent->_parent)
+	{
+		auto offset = position(parent, node);
+		for (SizeType child = 0; child < offset; ++child)
+			index += parent->_counts[child];
+	}
+	return index;
+}
+
+// 获取指定次序的元素
+template <typename _Type, typename _Compare>
+auto BPlusTree<_Type, _Compare>::select(SizeType _index) const noexcept \
+-> Iterator
+{
+	if (_index >= size()) return end();
+
+	const Node* node = _root;
+	while (!node->_leaf)
+	{
+		auto internal = static_cast<const Internal*>(node);
+		SizeType child = 0;
+		for (; _index >= internal->_counts[child]; ++child)
+			_index -= internal->_counts[child];
+		node = internal->_children[child];
+	}
+	return Iterator(this, static_cast<const Leaf*>(node), _index);
+}
@@ -0,0 +1,721 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/*
+ * 顺序统计树
+ * 以树堆实现的有序集合，节点记录子树大小，按照次序查找元素与计算元素的次序都只需对数时间。
+ * 节点按照键值满足二叉查找树性质，按照随机优先级满足大顶堆性质，期望树高为对数级别。
+ * 节点持有父节点指针，迭代器只需节点指针即可双向遍历，修改元素无需销毁再创建节点。
+ * 接口与std::set保持一致，元素不可重复，另外提供rank、select与modify方法。
+ */
+template <typename _Type, typename _Compare = std::less<_Type>>
+class OrderStatisticTree
+{
+	struct Node;
+
+public:
+	using ValueType = _Type;
+	using SizeType = std::size_t;
+
+	using value_type = ValueType;
+	using size_type = SizeType;
+
+	class Iterator;
+
+	using iterator = Iterator;
+	using const_iterator = Iterator;
+	using reverse_iterator = std::reverse_iterator<Iterator>;
+	using const_reverse_iterator = reverse_iterator;
+
+private:
+	Node* _root;
+	std::uint32_t _seed;
+	_Compare _compare;
+
+private:
+	static SizeType getSize(const Node* _node) noexcept
+	{
+		return _node != nullptr ? _node->_size : 0;
+	}
+
+	static void resize(Node* _node) noexcept
+	{
+		_node->_size = getSize(_node->_left) + getSize(_node->_right) + 1;
+	}
+
+	static const Node* minimum(const Node* _node) noexcept;
+
+	static const Node* maximum(const Node* _node) noexcept;
+
+	static const Node* next(const Node* _node) noexcept;
+
+	static const Node* previous(const Node* _node) noexcept;
+
+	static void destroy(Node* _node) noexcept;
+
+	static Node* clone(const Node* _node, Node* _parent);
+
+	// 生成节点优先级
+	std::uint32_t random() noexcept
+	{
+		_seed ^= _seed << 13;
+		_seed ^= _seed >> 17;
+		_seed ^= _seed << 5;
+		return _seed;
+	}
+
+	// 查找插入位置，倘若存在等价元素，返回其节点
+	Node* locate(const ValueType& _value, \
+		Node*& _parent, bool& _left) const;
+
+	// 将节点旋转至父节点的位置
+	void rotate(Node* _node) noexcept;
+
+	// 作为叶节点挂接于指定位置，再按照优先级向上旋转
+	void attach(Node* _node, Node* _parent, bool _left) noexcept;
+
+	// 将节点向下旋转至叶节点，再从树中摘除，节点本身不销毁
+	void detach(Node* _node) noexcept;
+
+public:
+	OrderStatisticTree() : \
+		_root(nullptr), _seed(0x9E3779B9U) {}
+
+	OrderStatisticTree(const OrderStatisticTree& _another) : \
+		_root(clone(_another._root, nullptr)), \
+		_seed(_another._seed), _compare(_another._compare) {}
+
+	OrderStatisticTree(OrderStatisticTree&& _another) noexcept : \
+		_root(std::exchange(_another._root, nullptr)), \
+		_seed(_another._seed), _compare(std::move(_another._compare)) {}
+
+	~OrderStatisticTree() noexcept
+	{
+		destroy(_root);
+	}
+
+	OrderStatisticTree& operator=(const OrderStatisticTree& _tree)
+	{
+		if (&_tree != this)
+		{
+			OrderStatisticTree tree(_tree);
+			swap(tree);
+		}
+		return *this;
+	}
+
+	OrderStatisticTree& operator=(OrderStatisticTree&& _tree) noexcept
+	{
+		if (&_tree != this)
+		{
+			clear();
+			swap(_tree);
+		}
+		return *this;
+	}
+
+	void swap(OrderStatisticTree& _tree) noexcept
+	{
+		using std::swap;
+		swap(_root, _tree._root);
+		swap(_seed, _tree._seed);
+		swap(_compare, _tree._compare);
+	}
+
+	bool empty() const noexcept
+	{
+		return _root == nullptr;
+	}
+
+	SizeType size() const noexcept
+	{
+		return getSize(_root);
+	}
+
+	void clear() noexcept
+	{
+		destroy(_root);
+		_root = nullptr;
+	}
+
+	Iterator begin() const noexcept
+	{
+		return Iterator(this, minimum(_root));
+	}
+
+	Iterator end() const noexcept
+	{
+		return Iterator(this, nullptr);
+	}
+
+	Iterator cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	Iterator cend() const noexcept
+	{
+		return end();
+	}
+
+	reverse_iterator rbegin() const noexcept
+	{
+		return reverse_iterator(end());
+	}
+
+	reverse_iterator rend() const noexcept
+	{
+		return reverse_iterator(begin());
+	}
+
+	reverse_iterator crbegin() const noexcept
+	{
+		return rbegin();
+	}
+
+	reverse_iterator crend() const noexcept
+	{
+		return rend();
+	}
+
+	/*
+	 * 从有序且不重复的区间批量构建，替换原有元素
+	 * 以区间中点为根构建平衡树，优先级值域按照层数等分，层数越深则区间越低，每层在所属区间内随机生成，
+	 * 子节点的优先级必然低于父节点，满足大顶堆性质，无需排序，只需线性时间。
+	 */
+	template <typename _Iterator>
+	void assign(_Iterator _first, _Iterator _last);
+
+	// 查找等价元素，若无则返回尾迭代器
+	Iterator find(const ValueType& _value) const;
+
+	// 插入元素，倘若存在等价元素，则不插入并且返回其迭代器
+	std::pair<Iterator, bool> insert(const ValueType& _value);
+
+	std::pair<Iterator, bool> insert(ValueType&& _value);
+
+	/*
+	 * 以指定函数修改元素，倘若次序不变，则原地修改，否则摘除节点，再按照新的次序挂接节点
+	 * 倘若修改之后存在等价元素，则销毁节点并且返回等价元素的迭代器。
+	 */
+	template <typename _Function>
+	std::pair<Iterator, bool> modify(Iterator _position, _Function&& _function);
+
+	// 以新元素替换指定元素，复用原有节点
+	std::pair<Iterator, bool> replace(Iterator _position, const ValueType& _value)
+	{
+		return modify(_position, [&_value](ValueType& _element)
+			{
+				_element = _value;
+			});
+	}
+
+	// 移除指定元素，返回后继元素的迭代器
+	Iterator erase(Iterator _position) noexcept;
+
+	// 移除等价元素，返回移除数量
+	SizeType erase(const ValueType& _value);
+
+	// 获取元素的次序，从零开始计数，尾迭代器的次序为元素数量
+	SizeType rank(Iterator _position) const noexcept;
+
+	// 获取指定次序的元素，越界则返回尾迭代器
+	Iterator select(SizeType _index) const noexcept;
+};
+
+template <typename _Type, typename _Compare>
+struct OrderStatisticTree<_Type, _Compare>::Node
+{
+	ValueType _value;
+	Node* _parent;
+	Node* _left;
+	Node* _right;
+	SizeType _size;
+	std::uint32_t _priority;
+
+	template <typename... _Args>
+	explicit Node(std::uint32_t _priority, _Args&&... _args) : \
+		_value(std::forward<_Args>(_args)...), \
+		_parent(nullptr), _left(nullptr), _right(nullptr), \
+		_size(1), _priority(_priority) {}
+};
+
+template <typename _Type, typename _Compare>
+class OrderStatisticTree<_Type, _Compare>::Iterator
+{
+	friend class OrderStatisticTree;
+
+public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = ValueType;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const ValueType*;
+	using reference = const ValueType&;
+
+private:
+	const OrderStatisticTree* _tree;
+	const Node* _node;
+
+private:
+	Iterator(const OrderStatisticTree* _tree, const Node* _node) noexcept : \
+		_tree(_tree), _node(_node) {}
+
+public:
+	Iterator() noexcept : \
+		_tree(nullptr), _node(nullptr) {}
+
+	reference operator*() const noexcept
+	{
+		return _node->_value;
+	}
+
+	pointer operator->() const noexcept
+	{
+		return &_node->_value;
+	}
+
+	Iterator& operator++() noexcept
+	{
+		_node = next(_node);
+		return *this;
+	}
+
+	Iterator operator++(int) noexcept
+	{
+		auto iterator = *this;
+		++*this;
+		return iterator;
+	}
+
+	// 尾迭代器递减则指向最大元素
+	Iterator& operator--() noexcept
+	{
+		_node = _node != nullptr ? \
+			previous(_node) : maximum(_tree->_root);
+		return *this;
+	}
+
+	Iterator operator--(int) noexcept
+	{
+		auto iterator = *this;
+		--*this;
+		return iterator;
+	}
+
+	bool operator==(const Iterator& _iterator) const noexcept
+	{
+		return _node == _iterator._node;
+	}
+};
+
+template <typename _Type, typename _Compare>
+auto OrderStatisticTree<_Type, _Compare>::minimum(const Node* _node) noexcept \
+-> const Node*
+{
+	if (_node != nullptr)
+		while (_node->_left != nullptr)
+			_node = _node->_left;
+	return _node;
+}
+
+template <typename _Type, typename _Compare>
+auto OrderStatisticTree<_Type, _Compare>::maximum(const Node* _node) noexcept \
+-> const Node*
+{
+	if (_node != nullptr)
+		while (_node->_right != nullptr)
+			_node = _node->_right;
+	return _node;
+}
+
+template <typename _Type, typename _Compare>
+auto OrderStatisticTree<_Type, _Compare>::next(const Node* _node) noexcept \
+-> const Node*
+{
+	if (_node->_right != nullptr)
+		return minimum(_node->_right);
+
+	auto parent = _node->_parent;
+	while (parent != nullptr && _node == parent->_right)
+	{
+		_node = parent;
+		parent = parent->_parent;
+	}
+	return parent;
+}
+
+template <typename _Type, typename _Compare>
+auto OrderStatisticTree<_Type, _Compare>::previous(const Node* _node) noexcept \
+-> const Node*
+{
+	if (_node->_left != nullptr)
+		return maximum(_node->_left);
+
+	auto parent = _node->_parent;
+	while (parent != nullptr && _node == parent->_left)
+	{
+		_node = parent;
+		parent = parent->_parent;
+	}
+	return parent;
+}
+
+// 期望树高为对数级别，递归深度有限
+template <typename _Type, typename _Compare>
+void OrderStatisticTree<_Type, _Compare>::destroy(Node* _node) noexcept
+{
+	if (_node == nullptr) return;
+
+	destroy(_node->_left);
+	destroy(_node->_right);
+	delete _node;
+}
+
+// 复制子树，保留优先级与结构
+template <typename _Type, typename _Compare>
+auto OrderStatisticTree<_Type, _Compare>::clone(const Node* _node, Node* _parent) \
+-> Node*
+{
+	if (_node == nullptr) return nullptr;
+
+	auto node = new Node(_node->_priority, _node->_value);
+	node->_parent = _parent;
+	node->_size = _node->_size;
+	try
+	{
+		node->_left = clone(_node->_left, node);
+		node->_right = clone(_node->_right, node);
+	}
+	catch (...)
+	{
+		destroy(node);
+		throw;
+	}
+	return node;
+}
+
+template <typename _Type, typename _Compare>
+auto OrderStatisticTree<_Type, _Compare>::locate(const ValueType& _value, \
+	Node*& _parent, bool& _left) const -> Node*
+{
+	_parent = nullptr;
+	_left = false;
+	for (auto node = _root; node != nullptr;)
+	{
+		_parent = node;
+		if (_compare(_value, node->_value))
+		{
+			node = node->_left;
+			_left = true;
+		}
+		else if (_compare(node->_value, _value))
+		{
+			node = node->_right;
+			_left = false;
+		}
+		else return node;
+	}
+	return nullptr;
+}
+
+template <typename _Type, typename _Compare>
+void OrderStatisticTree<_Type, _Compare>::rotate(Node* _node) noexcept
+{
+	auto parent = _node->_parent;
+	auto grandparent = parent->_parent;
+
+	if (_node == parent->_left)
+	{
+		parent->_left = _node->_right;
+		if (parent->_left != nullptr)
+			parent->_left->_parent = parent;
+		_node->_right = parent;
+	}
+	else
+	{
+		parent->_right = _node->_left;
+		if (parent->_right != nullptr)
+			parent->_right->_parent = parent;
+		_node->_left = parent;
+	}
+
+	parent->_parent = _node;
+	_node->_parent = grandparent;
+	if (grandparent == nullptr)
+		_root = _node;
+	else if (grandparent->_left == parent)
+		grandparent->_left = _node;
+	else
+		grandparent->_right = _node;
+
+	// 旋转之后节点继承原父节点的子树大小
+	_node->_size = parent->_size;
+	resize(parent);
+}
+
+template <typename _Type, typename _Compare>
+void OrderStatisticTree<_Type, _Compare>::attach(Node* _node, \
+	Node* _parent, bool _left) noexcept
+{
+	_node->_parent = _parent;
+	if (_parent == nullptr)
+		_root = _node;
+	else if (_left)
+		_parent->_left = _node;
+	else
+		_parent->_right = _node;
+
+	for (auto node = _parent; node != nullptr; node = node->_parent)
+		++node->_size;
+
+	while (_node->_parent != nullptr \
+		&& _node->_priority > _node->_parent->_priority)
+		rotate(_node);
+}
+
+template <typename _Type, typename _Compare>
+void OrderStatisticTree<_Type, _Compare>::detach(Node* _node) noexcept
+{
+	while (_node->_left != nullptr && _node->_right != nullptr)
+		rotate(_node->_left->_priority > _node->_right->_priority ? \
+			_node->_left : _node->_right);
+
+	auto child = _node->_left != nullptr ? _node->_left : _node->_right;
+	auto parent = _node->_parent;
+	if (child != nullptr)
+		child->_parent = parent;
+
+	if (parent == nullptr)
+		_root = child;
+	else if (parent->_left == _node)
+		parent->_left = child;
+	else
+		parent->_right = child;
+
+	for (auto node = parent; node != nullptr; node = node->_parent)
+		--node->_size;
+
+	_node->_parent = _node->_left = _node->_right = nullptr;
+	_node->_size = 1;
+}
+
+// 批量构建
+template <typename _Type, typename _Compare>
+template <typename _Iterator>
+void OrderStatisticTree<_Type, _Compare>::assign(_Iterator _first, _Iterator _last)
+{
+	struct Range
+	{
+		SizeType _begin;
+		SizeType _end;
+		Node* _parent;
+		bool _left;
+		SizeType _depth;
+	};
+
+	clear();
+	auto size = static_cast<SizeType>(std::distance(_first, _last));
+	if (size <= 0) return;
+
+	// 中点划分的树高为size的有效位数，每层的优先级区间宽度
+	auto levels = static_cast<std::uint64_t>(std::bit_width(size));
+	auto width = (std::uint64_t(1) << 32) / levels;
+
+	std::vector<Range> ranges;
+	ranges.reserve(size);
+
+	std::vector<Node*> nodes;
+	nodes.reserve(size);
+	try
+	{
+		for (; _first != _last; ++_first)
+			nodes.push_back(new Node(0, *_first));
+	}
+	catch (...)
+	{
+		for (auto node : nodes)
+			delete node;
+		throw;
+	}
+
+	// 以向量作为队列，按照广度优先顺序构建
+	ranges.push_back(Range{ 0, size, nullptr, false, 0 });
+	for (SizeType index = 0; index < ranges.size(); ++index)
+	{
+		auto range = ranges[index];
+		auto middle = range._begin + (range._end - range._begin) / 2;
+		auto node = nodes[middle];
+		node->_priority = static_cast<std::uint32_t>( \
+			(levels - 1 - range._depth) * width + random() % width);
+		node->_size = range._end - range._begin;
+		node->_parent = range._parent;
+
+		if (range._parent == nullptr)
+			_root = node;
+		else if (range._left)
+			range._parent->_left = node;
+		else
+			range._parent->_right = node;
+
+		if (range._begin < middle)
+			ranges.push_back(Range{ range._begin, middle, node, true, range._depth + 1 });
+		if (middle + 1 < range._end)
+			ranges.push_back(Range{ middle + 1, range._end, node, false, range._depth + 1 });
+	}
+}
+
+// 查找等价元素
+template <typename _Type, typename _Compare>
+auto OrderStatisticTree<_Type, _Compare>::find(const ValueType& _value) const \
+-> Iterator
+{
+	Node* parent = nullptr;
+	bool left = false;
+	return Iterator(this, locate(_value, parent, left));
+}
+
+// 插入元素
+template <typename _Type, typename _Compare>
+auto OrderStatisticTree<_Type, _Compare>::insert(const ValueType& _value) \
+-> std::pair<Iterator, bool>
+{
+	Node* parent = nullptr;
+	bool left = false;
+	if (auto node = locate(_value, parent, left))
+		return std::make_pair(Iterator(this, node), false);
+
+	auto node = new Node(random(), _value);
+	attach(node, parent, left);
+	return std::make_pair(Iterator(this, node), true);
+}
+
+template <typename _Type, typename _Compare>
+auto OrderStatisticTree<_Type, _Compare>::insert(ValueType&& _value) \
+-> std::pair<Iterator, bool>
+{
+	Node* parent = nullptr;
+	bool left = false;
+	if (auto node = locate(_value, parent, left))
+		return std::make_pair(Iterator(this, node), false);
+
+	auto node = new Node(random(), std::move(_value));
+	attach(node, parent, left);
+	return std::make_pair(Iterator(this, node), true);
+}
+
+// 修改元素
+template <typename _Type, typename _Compare>
+template <typename _Function>
+auto OrderStatisticTree<_Type, _Compare>::modify(Iterator _position, \
+	_Function&& _function) -> std::pair<Iterator, bool>
+{
+	auto node = const_cast<Node*>(_position._node);
+	try
+	{
+		_function(node->_value);
+	}
+	catch (...)
+	{
+		detach(node);
+		delete node;
+		throw;
+	}
+
+	// 与前驱和后继比较，次序不变则无需旋转
+	auto predecessor = previous(node), successor = next(node);
+	if ((predecessor == nullptr || _compare(predecessor->_value, node->_value)) \
+		&& (successor == nullptr || _compare(node->_value, successor->_value)))
+		return std::make_pair(_position, true);
+
+	detach(node);
+
+	Node* parent = nullptr;
+	bool left = false;
+	Node* equivalent = nullptr;
+	try
+	{
+		equivalent = locate(node->_value, parent, left);
+	}
+	catch (...)
+	{
+		delete node;
+		throw;
+	}
+
+	if (equivalent != nullptr)
+	{
+		delete node;
+		return std::make_pair(Iterator(this, equivalent), false);
+	}
+
+	attach(node, parent, left);
+	return std::make_pair(Iterator(this, node), true);
+}
+
+// 移除指定元素
+template <typename _Type, typename _Compare>
+auto OrderStatisticTree<_Type, _Compare>::erase(Iterator _position) noexcept \
+-> Iterator
+{
+	auto node = const_cast<Node*>(_position._node);
+	auto successor = next(node);
+	detach(node);
+	delete node;
+	return Iterator(this, successor);
+}
+
+// 移除等价元素
+template <typename _Type, typename _Compare>
+auto OrderStatisticTree<_Type, _Compare>::erase(const ValueType& _value) \
+-> SizeType
+{
+	auto iterator = find(_value);
+	if (iterator == end()) return 0;
+
+	erase(iterator);
+	return 1;
+}
+
+// 获取元素的次序
+template <typename _Type, typename _Compare>
+auto OrderStatisticTree<_Type, _Compare>::rank(Iterator _position) const noexcept \
+-> SizeType
+{
+	auto node = _position._node;
+	if (node == nullptr) return size();
+
+	auto index = getSize(node->_left);
+	for (; node->_parent != nullptr; node = node->_parent)
+		if (node == node->_parent->_right)
+			index += getSize(node->_parent->_left) + 1;
+	return index;
+}
+
+// 获取指定次序的元素
+template <typename _Type, typename _Compare>
+auto OrderStatisticTree<_Type, _Compare>::select(SizeType _index) const noexcept \
+-> Iterator
+{
+	if (_index >= size()) return end();
+
+	auto node = _root;
+	while (true)
+	{
+		auto size = getSize(node->_left);
+		if (_index < size)
+			node = node->_left;
+		else if (_index > size)
+		{
+			_index -= size + 1;
+			node = node->_right;
+		}
+		else return Iterator(this, node);
+	}
+}
@@ -1,11 +1,14 @@
 ﻿#pragma once
 
+#include "OrderStatisticTree.hpp"
+#include "BPlusTree.hpp"
+
 #include <utility>
 #include <memory>
-#include <set>
 #include <unordered_map>
 #include <vector>
 #include <iterator>
+#include <ranges>
 #include <algorithm>
 
 template <typename _IDType>
@@ -25,7 +28,12 @@ public:
 	}
 };
 
-template <typename _IDType, typename _Record>
+/*
+ * 有序集合以模板参数选择，默认为顺序统计树，可选B+树
+ * 顺序统计树的每条记录独占节点，修改之时不移动记录；B+树的记录连续存储于叶节点，获取排行榜与分页读取只需顺序扫描内存。
+ */
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet = OrderStatisticTree>
 class Sorter final
 {
 public:
@@ -37,27 +45,24 @@ public:
 
 private:
 	using IDMapper = std::unordered_map<IDType, Record>;
-	using RecordSet = std::set<Record>;
+	using RecordSet = _OrderedSet<Record>;
+
+private:
+	// 批量更新的数量不少于记录总量的四分之一，则整体排序重建有序集合
+	static constexpr SizeType REBUILD_RATIO = 4;
 
 private:
 	IDMapper _idMapper;
 	RecordSet _recordSet;
 
 private:
-	/*
-	 * 根据指定方向遍历，获取指定ID的排名
-	 * 若无指定ID，则返回0。
-	 */
+	// 从指定迭代器起，获取指定数量的记录
 	template <typename _Iterator>
-	auto rank(IDType _id, _Iterator _iterator) const;
+	static void fetch(RecordList& _recordList, \
+		SizeType _size, _Iterator _iterator);
 
-	/*
-	 * 从指定位置起，向指定方向遍历，获取指定数量的记录
-	 * 倘若指定数量为零，默认获取所有记录，否则获取指定数量的记录。
-	 */
-	template <typename _Iterator>
-	void get(RecordList& _recordList, SizeType _index, \
-		SizeType _size, _Iterator _iterator) const;
+	// 根据映射的所有记录排序，批量重建有序集合
+	void rebuild();
 
 public:
 	// 是否为空
@@ -87,6 +92,22 @@ public:
 	 */
 	void update(const Record& _record);
 
+	/*
+	 * 批量新增或者更新记录
+	 * 要求前向迭代器，先计算数量再逐条遍历，单趟迭代器将于计算数量之时耗尽。
+	 * 映射只预留一次空间，同一ID以最后一条记录为准。
+	 * 倘若更新数量不少于记录总量的四分之一，则先更新映射，再整体排序重建有序集合，否则逐条更新。
+	 * 重建期间发生异常则清空数据。
+	 */
+	template <std::forward_iterator _Iterator, std::sentinel_for<_Iterator> _Sentinel>
+	void update(_Iterator _first, _Sentinel _last);
+
+	template <std::ranges::forward_range _Range>
+	void update(const _Range& _range)
+	{
+		update(std::ranges::begin(_range), std::ranges::end(_range));
+	}
+
 	// 移除单条记录，返回移除结果
 	bool remove(IDType _id);
 
@@ -107,14 +128,10 @@ public:
 	}
 
 	/*
-	 * 根据指定方向遍历，获取指定ID的排名
+	 * 根据指定方向，获取指定ID的排名
 	 * 若无指定ID，则返回0。
 	 */
-	auto rank(IDType _id, bool _forward = false) const
-	{
-		return _forward ? \
-			rank(_id, _recordSet.cbegin()) : rank(_id, _recordSet.crbegin());
-	}
+	SizeType rank(IDType _id, bool _forward = false) const;
 
 	/*
 	 * 从指定位置起，向指定方向遍历，获取指定数量的记录
@@ -124,7 +141,8 @@ public:
 		SizeType _size = 0, bool _forward = false) const;
 };
 
-template <typename _IDType, typename _Record>
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet = OrderStatisticTree>
 class SharedSorter final
 {
 	struct Node;
@@ -140,7 +158,11 @@ private:
 	using NodeType = Node;
 	using IDMapper = std::unordered_map<IDType, NodeType>;
 	using PairType = IDMapper::value_type;
-	using NodeSet = std::set<NodeType>;
+	using NodeSet = _OrderedSet<NodeType>;
+
+private:
+	// 批量更新的数量不少于记录总量的四分之一，则整体排序重建有序集合
+	static constexpr SizeType REBUILD_RATIO = 4;
 
 private:
 	IDMapper _idMapper;
@@ -153,20 +175,17 @@ private:
 	 */
 	void copy(const SharedSorter& _sorter);
 
-	/*
-	 * 根据指定方向遍历，获取指定ID的排名
-	 * 若无指定ID，则返回0。
-	 */
+	// 从指定迭代器起，获取指定数量的记录
 	template <typename _Iterator>
-	auto rank(IDType _id, _Iterator _iterator) const;
+	static void fetch(RecordList& _recordList, \
+		SizeType _size, _Iterator _iterator);
 
-	/*
-	 * 从指定位置起，向指定方向遍历，获取指定数量的记录
-	 * 倘若指定数量为零，默认获取所有记录，否则获取指定数量的记录。
-	 */
-	template <typename _Iterator>
-	void get(RecordList& _recordList, SizeType _index, \
-		SizeType _size, _Iterator _iterator) const;
+	// 从指定位置起，向指定方向获取指定数量的记录
+	void fetch(RecordList& _recordList, SizeType _index, \
+		SizeType _size, bool _forward) const;
+
+	// 根据映射的所有记录排序，批量重建有序集合
+	void rebuild();
 
 public:
 	SharedSorter() = default;
@@ -210,6 +229,22 @@ public:
 	 */
 	void update(const Record& _record);
 
+	/*
+	 * 批量新增或者更新记录
+	 * 要求前向迭代器，先计算数量再逐条遍历，单趟迭代器将于计算数量之时耗尽。
+	 * 映射只预留一次空间，同一ID以最后一条记录为准。
+	 * 倘若更新数量不少于记录总量的四分之一，则先更新映射，再整体排序重建有序集合，否则逐条更新。
+	 * 重建期间发生异常则清空数据。
+	 */
+	template <std::forward_iterator _Iterator, std::sentinel_for<_Iterator> _Sentinel>
+	void update(_Iterator _first, _Sentinel _last);
+
+	template <std::ranges::forward_range _Range>
+	void update(const _Range& _range)
+	{
+		update(std::ranges::begin(_range), std::ranges::end(_range));
+	}
+
 	// 移除单条记录，返回移除结果
 	bool remove(IDType _id);
 
@@ -230,14 +265,10 @@ public:
 	}
 
 	/*
-	 * 根据指定方向遍历，获取指定ID的排名
+	 * 根据指定方向，获取指定ID的排名
 	 * 若无指定ID，则返回0。
 	 */
-	auto rank(IDType _id, bool _forward = false) const
-	{
-		return _forward ? \
-			rank(_id, _nodeSet.cbegin()) : rank(_id, _nodeSet.crbegin());
-	}
+	SizeType rank(IDType _id, bool _forward = false) const;
 
 	/*
 	 * 从指定位置起，向指定方向遍历，获取指定数量的记录
@@ -254,8 +285,9 @@ public:
 		SizeType _size = 0, bool _forward = false) const;
 };
 
-template <typename _IDType, typename _Record>
-struct SharedSorter<_IDType, _Record>::Node
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+struct SharedSorter<_IDType, _Record, _OrderedSet>::Node
 {
 	std::shared_ptr<Record> _record;
 
@@ -269,38 +301,21 @@ struct SharedSorter<_IDType, _Record>::Node
 	}
 };
 
-// 获取指定ID的排名
-template <typename _IDType, typename _Record>
-template <typename _Iterator>
-auto Sorter<_IDType, _Record>::rank(IDType _id, \
-	_Iterator _iterator) const
-{
-	decltype(size()) ranking = 0;
-	for (decltype(ranking) index = 0; \
-		index < size(); ++index, ++_iterator)
-		if (static_cast<IDType>(*_iterator) == _id)
-		{
-			ranking = index + 1;
-			break;
-		}
-	return ranking;
-}
-
 // 获取指定数量的记录
-template <typename _IDType, typename _Record>
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
 template <typename _Iterator>
-void Sorter<_IDType, _Record>::get(RecordList& _recordList, \
-	SizeType _index, SizeType _size, _Iterator _iterator) const
+void Sorter<_IDType, _Record, _OrderedSet>::fetch(RecordList& _recordList, \
+	SizeType _size, _Iterator _iterator)
 {
-	for (; _index > 0; --_index, ++_iterator);
-
 	for (; _size > 0; --_size)
 		_recordList.push_back(*_iterator++);
 }
 
 // 查找指定ID的原始记录
-template <typename _IDType, typename _Record>
-auto Sorter<_IDType, _Record>::find(IDType _id) const \
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+auto Sorter<_IDType, _Record, _OrderedSet>::find(IDType _id) const \
 -> const Record*
 {
 	auto iterator = _idMapper.find(_id);
@@ -309,8 +324,9 @@ auto Sorter<_IDType, _Record>::find(IDType _id) const \
 }
 
 // 新增或者更新记录
-template <typename _IDType, typename _Record>
-void Sorter<_IDType, _Record>::update(const Record& _record)
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+void Sorter<_IDType, _Record, _OrderedSet>::update(const Record& _record)
 {
 	auto id = static_cast<IDType>(_record);
 	if (auto iterator = _idMapper.find(id); \
@@ -321,15 +337,70 @@ void Sorter<_IDType, _Record>::update(const Record& _record)
 	}
 	else
 	{
-		auto node = _recordSet.extract(iterator->second);
-		node.value() = iterator->second = _record;
-		_recordSet.insert(std::move(node));
+		auto position = _recordSet.find(iterator->second);
+		_recordSet.replace(position, _record);
+		iterator->second = _record;
 	}
 }
 
+// 批量新增或者更新记录
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+template <std::forward_iterator _Iterator, std::sentinel_for<_Iterator> _Sentinel>
+void Sorter<_IDType, _Record, _OrderedSet>::update(_Iterator _first, _Sentinel _last)
+{
+	auto number = static_cast<SizeType>(std::ranges::distance(_first, _last));
+	_idMapper.reserve(_idMapper.size() + number);
+
+	if (number * REBUILD_RATIO < size())
+	{
+		for (; _first != _last; ++_first)
+			update(*_first);
+		return;
+	}
+
+	try
+	{
+		for (; _first != _last; ++_first)
+		{
+			const Record& record = *_first;
+			_idMapper.insert_or_assign(static_cast<IDType>(record), record);
+		}
+		rebuild();
+	}
+	catch (...)
+	{
+		clear();
+		throw;
+	}
+}
+
+// 批量重建有序集合
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+void Sorter<_IDType, _Record, _OrderedSet>::rebuild()
+{
+	RecordList recordList;
+	recordList.reserve(_idMapper.size());
+	for (const auto& pair : _idMapper)
+		recordList.push_back(pair.second);
+
+	// 与有序集合一致，等价记录只保留一条
+	std::sort(recordList.begin(), recordList.end());
+	auto last = std::unique(recordList.begin(), recordList.end(), \
+		[](const Record& _left, const Record& _right)
+		{
+			return !(_left < _right) && !(_right < _left);
+		});
+
+	_recordSet.assign(std::make_move_iterator(recordList.begin()), \
+		std::make_move_iterator(last));
+}
+
 // 移除单条记录
-template <typename _IDType, typename _Record>
-bool Sorter<_IDType, _Record>::remove(IDType _id)
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+bool Sorter<_IDType, _Record, _OrderedSet>::remove(IDType _id)
 {
 	auto iterator = _idMapper.find(_id);
 	if (iterator == _idMapper.end()) return false;
@@ -340,17 +411,32 @@ bool Sorter<_IDType, _Record>::remove(IDType _id)
 }
 
 // 获取首记录
-template <typename _IDType, typename _Record>
-auto Sorter<_IDType, _Record>::front(bool _forward) const noexcept \
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+auto Sorter<_IDType, _Record, _OrderedSet>::front(bool _forward) const noexcept \
 -> const Record*
 {
 	if (empty()) return nullptr;
 	return _forward ? &*_recordSet.cbegin() : &*_recordSet.crbegin();
 }
 
+// 获取指定ID的排名
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+auto Sorter<_IDType, _Record, _OrderedSet>::rank(IDType _id, bool _forward) const \
+-> SizeType
+{
+	auto iterator = _idMapper.find(_id);
+	if (iterator == _idMapper.end()) return 0;
+
+	auto index = _recordSet.rank(_recordSet.find(iterator->second));
+	return _forward ? index + 1 : size() - index;
+}
+
 // 获取指定数量的记录
-template <typename _IDType, typename _Record>
-bool Sorter<_IDType, _Record>::get(RecordList& _recordList, \
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+bool Sorter<_IDType, _Record, _OrderedSet>::get(RecordList& _recordList, \
 	SizeType _index, SizeType _size, bool _forward) const
 {
 	_recordList.clear();
@@ -360,16 +446,19 @@ bool Sorter<_IDType, _Record>::get(RecordList& _recordList, \
 	else _size = std::min(size() - _index, _size);
 	_recordList.reserve(_size);
 
+	// 按照次序定位起始记录，无需逐个遍历
 	if (_forward)
-		get(_recordList, _index, _size, _recordSet.cbegin());
+		fetch(_recordList, _size, _recordSet.select(_index));
 	else
-		get(_recordList, _index, _size, _recordSet.crbegin());
+		fetch(_recordList, _size, \
+			std::make_reverse_iterator(_recordSet.select(size() - _index)));
 	return true;
 }
 
 // 复制数据
-template <typename _IDType, typename _Record>
-void SharedSorter<_IDType, _Record>::copy(const SharedSorter& _sorter)
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+void SharedSorter<_IDType, _Record, _OrderedSet>::copy(const SharedSorter& _sorter)
 {
 	std::transform(_sorter._idMapper.cbegin(), _sorter._idMapper.cend(), \
 		std::inserter(this->_idMapper, this->_idMapper.begin()), \
@@ -381,35 +470,33 @@ void SharedSorter<_IDType, _Record>::copy(const SharedSorter& _sorter)
 		});
 }
 
-// 获取指定ID的排名
-template <typename _IDType, typename _Record>
-template <typename _Iterator>
-auto SharedSorter<_IDType, _Record>::rank(IDType _id, _Iterator _iterator) const
-{
-	decltype(size()) ranking = 0;
-	for (decltype(ranking) index = 0; index < size(); ++index, ++_iterator)
-		if (static_cast<IDType>(*_iterator->_record) == _id)
-		{
-			ranking = index + 1;
-			break;
-		}
-	return ranking;
-}
-
 // 获取指定数量的记录
-template <typename _IDType, typename _Record>
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
 template <typename _Iterator>
-void SharedSorter<_IDType, _Record>::get(RecordList& _recordList, \
-	SizeType _index, SizeType _size, _Iterator _iterator) const
+void SharedSorter<_IDType, _Record, _OrderedSet>::fetch(RecordList& _recordList, \
+	SizeType _size, _Iterator _iterator)
 {
-	for (; _index > 0; --_index, ++_iterator);
-
 	for (; _size > 0; --_size)
 		_recordList.push_back(*(*_iterator++)._record);
 }
 
-template <typename _IDType, typename _Record>
-auto SharedSorter<_IDType, _Record>::operator=(const SharedSorter& _sorter) \
+// 按照次序定位起始记录，无需逐个遍历
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+void SharedSorter<_IDType, _Record, _OrderedSet>::fetch(RecordList& _recordList, \
+	SizeType _index, SizeType _size, bool _forward) const
+{
+	if (_forward)
+		fetch(_recordList, _size, _nodeSet.select(_index));
+	else
+		fetch(_recordList, _size, \
+			std::make_reverse_iterator(_nodeSet.select(size() - _index)));
+}
+
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+auto SharedSorter<_IDType, _Record, _OrderedSet>::operator=(const SharedSorter& _sorter) \
 -> SharedSorter&
 {
 	if (&_sorter != this)
@@ -422,8 +509,9 @@ auto SharedSorter<_IDType, _Record>::operator=(const SharedSorter& _sorter) \
 }
 
 // 查找指定ID的原始记录
-template <typename _IDType, typename _Record>
-auto SharedSorter<_IDType, _Record>::find(IDType _id) const \
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+auto SharedSorter<_IDType, _Record, _OrderedSet>::find(IDType _id) const \
 -> std::shared_ptr<const Record>
 {
 	auto iterator = _idMapper.find(_id);
@@ -432,8 +520,9 @@ auto SharedSorter<_IDType, _Record>::find(IDType _id) const \
 }
 
 // 新增或者更新记录
-template <typename _IDType, typename _Record>
-void SharedSorter<_IDType, _Record>::update(const Record& _record)
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+void SharedSorter<_IDType, _Record, _OrderedSet>::update(const Record& _record)
 {
 	auto id = static_cast<IDType>(_record);
 	if (auto iterator = _idMapper.find(id); \
@@ -445,15 +534,77 @@ void SharedSorter<_IDType, _Record>::update(const Record& _record)
 	}
 	else
 	{
-		auto node = _nodeSet.extract(iterator->second);
-		*node.value()._record = *iterator->second._record = _record;
-		_nodeSet.insert(std::move(node));
+		// 记录由映射与集合的节点共享，经由集合修改记录，以便调整次序
+		auto position = _nodeSet.find(iterator->second);
+		_nodeSet.modify(position, [&_record](NodeType& _node)
+			{
+				*_node._record = _record;
+			});
+	}
+}
+
+// 批量新增或者更新记录
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+template <std::forward_iterator _Iterator, std::sentinel_for<_Iterator> _Sentinel>
+void SharedSorter<_IDType, _Record, _OrderedSet>::update(_Iterator _first, _Sentinel _last)
+{
+	auto number = static_cast<SizeType>(std::ranges::distance(_first, _last));
+	_idMapper.reserve(_idMapper.size() + number);
+
+	if (number * REBUILD_RATIO < size())
+	{
+		for (; _first != _last; ++_first)
+			update(*_first);
+		return;
+	}
+
+	// 原地修改共享的记录会破坏集合的次序，因此先清空集合
+	_nodeSet.clear();
+	try
+	{
+		for (; _first != _last; ++_first)
+		{
+			const Record& record = *_first;
+			auto [iterator, inserted] = _idMapper.try_emplace(static_cast<IDType>(record), record);
+			if (!inserted)
+				*iterator->second._record = record;
+		}
+		rebuild();
+	}
+	catch (...)
+	{
+		clear();
+		throw;
 	}
 }
 
+// 批量重建有序集合
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+void SharedSorter<_IDType, _Record, _OrderedSet>::rebuild()
+{
+	std::vector<NodeType> nodes;
+	nodes.reserve(_idMapper.size());
+	for (const auto& pair : _idMapper)
+		nodes.push_back(pair.second);
+
+	// 与有序集合一致，等价记录只保留一条
+	std::sort(nodes.begin(), nodes.end());
+	auto last = std::unique(nodes.begin(), nodes.end(), \
+		[](const NodeType& _left, const NodeType& _right)
+		{
+			return !(_left < _right) && !(_right < _left);
+		});
+
+	_nodeSet.assign(std::make_move_iterator(nodes.begin()), \
+		std::make_move_iterator(last));
+}
+
 // 移除单条记录
-template <typename _IDType, typename _Record>
-bool SharedSorter<_IDType, _Record>::remove(IDType _id)
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+bool SharedSorter<_IDType, _Record, _OrderedSet>::remove(IDType _id)
 {
 	auto iterator = _idMapper.find(_id);
 	if (iterator == _idMapper.end()) return false;
@@ -464,8 +615,9 @@ bool SharedSorter<_IDType, _Record>::remove(IDType _id)
 }
 
 // 获取首记录
-template <typename _IDType, typename _Record>
-auto SharedSorter<_IDType, _Record>::front(bool _forward) const noexcept \
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+auto SharedSorter<_IDType, _Record, _OrderedSet>::front(bool _forward) const noexcept \
 -> std::shared_ptr<const Record>
 {
 	if (empty()) return nullptr;
@@ -473,9 +625,23 @@ auto SharedSorter<_IDType, _Record>::front(bool _forward) const noexcept \
 		_nodeSet.cbegin()->_record : _nodeSet.crbegin()->_record;
 }
 
+// 获取指定ID的排名
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+auto SharedSorter<_IDType, _Record, _OrderedSet>::rank(IDType _id, bool _forward) const \
+-> SizeType
+{
+	auto iterator = _idMapper.find(_id);
+	if (iterator == _idMapper.end()) return 0;
+
+	auto index = _nodeSet.rank(_nodeSet.find(iterator->second));
+	return _forward ? index + 1 : size() - index;
+}
+
 // 获取指定数量的记录
-template <typename _IDType, typename _Record>
-bool SharedSorter<_IDType, _Record>::get(RecordList& _recordList, \
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+bool SharedSorter<_IDType, _Record, _OrderedSet>::get(RecordList& _recordList, \
 	SizeType _index, SizeType _size, bool _forward) const
 {
 	_recordList.clear();
@@ -485,14 +651,14 @@ bool SharedSorter<_IDType, _Record>::get(RecordList& _recordList, \
 	else _size = std::min(size() - _index, _size);
 	_recordList.reserve(_size);
 
-	if (_forward) get(_recordList, _index, _size, _nodeSet.cbegin());
-	else get(_recordList, _index, _size, _nodeSet.crbegin());
+	fetch(_recordList, _index, _size, _forward);
 	return true;
 }
 
 // 获取指定数量的记录
-template <typename _IDType, typename _Record>
-auto SharedSorter<_IDType, _Record>::get(SizeType _index, SizeType _size, \
+template <typename _IDType, typename _Record, \
+	template <typename...> class _OrderedSet>
+auto SharedSorter<_IDType, _Record, _OrderedSet>::get(SizeType _index, SizeType _size, \
 	bool _forward) const -> std::shared_ptr<RecordList>
 {
 	if (_index >= size()) return nullptr;
@@ -503,7 +669,6 @@ auto SharedSorter<_IDType, _Record>::get(SizeType _index, SizeType _size, \
 	auto recordList = std::make_shared<RecordList>(0);
 	recordList->reserve(_size);
 
-	if (_forward) get(*recordList, _index, _size, _nodeSet.cbegin());
-	else get(*recordList, _index, _size, _nodeSet.crbegin());
+	fetch(*recordList, _index, _size, _forward);
 	return recordList;
 }
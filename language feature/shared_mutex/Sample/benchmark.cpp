@@ -0,0 +1,236 @@
+﻿/*
+ * 共享互斥元基准测试
+ * 遍历线程数量与读写比例，比较SharedMutex、SharedTimedMutex、DistributedSharedMutex、std::shared_mutex与std::mutex，
+ * 输出吞吐量与独占访问等待时长的百分位数。
+ * 用法：benchmark [每组测试的时长（毫秒）] [最大线程数量]
+ */
+#include "SharedMutex.hpp"
+#include "DistributedSharedMutex.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+using Nanosecond = std::chrono::nanoseconds;
+
+// 共享数据的字数，读者求和，写者逐字递增
+static constexpr std::size_t DATA_SIZE = 8;
+
+// 读者所占的百分比
+static constexpr unsigned READ_RATIOS[] = { 99, 90, 50 };
+
+struct Result
+{
+	double _throughput;
+	std::uint64_t _writes;
+	std::uint64_t _p50;
+	std::uint64_t _p90;
+	std::uint64_t _p99;
+	std::uint64_t _p999;
+	std::uint64_t _max;
+	bool _consistent;
+};
+
+// 统一共享访问接口，std::mutex以独占访问代替共享访问
+template <typename _MutexType>
+struct Locker
+{
+	static void lockShared(_MutexType& _mutex) { _mutex.lock_shared(); }
+	static void unlockShared(_MutexType& _mutex) { _mutex.unlock_shared(); }
+};
+
+template <>
+struct Locker<std::mutex>
+{
+	static void lockShared(std::mutex& _mutex) { _mutex.lock(); }
+	static void unlockShared(std::mutex& _mutex) { _mutex.unlock(); }
+};
+
+static std::uint32_t random(std::uint32_t& _seed) noexcept
+{
+	_seed ^= _seed << 13;
+	_seed ^= _seed >> 17;
+	_seed ^= _seed << 5;
+	return _seed;
+}
+
+static std::uint64_t percentile(const std::vector<std::uint64_t>& _latencies, \
+	double _rank) noexcept
+{
+	if (_latencies.empty()) return 0;
+
+	auto index = static_cast<std::size_t>(_rank * (_latencies.size() - 1));
+	return _latencies[index];
+}
+
+template <typename _MutexType>
+static Result run(std::size_t _threads, unsigned _readRatio, \
+	std::chrono::milliseconds _duration)
+{
+	_MutexType mutex;
+	std::uint64_t data[DATA_SIZE] = {};
+
+	std::atomic<bool> start(false), stop(false);
+	std::atomic<std::size_t> ready(0);
+	std::vector<std::uint64_t> operations(_threads, 0);
+	std::vector<std::vector<std::uint64_t>> latencies(_threads);
+	std::atomic<bool> consistent(true);
+
+	auto execute = [&](std::size_t _index)
+	{
+		auto seed = static_cast<std::uint32_t>(_index * 2654435761U) | 1;
+		auto& latency = latencies[_index];
+		latency.reserve(1 << 16);
+
+		std::uint64_t count = 0;
+		ready.fetch_add(1);
+		while (!start.load(std::memory_order_acquire))
+			std::this_thread::yield();
+
+		while (!stop.load(std::memory_order_relaxed))
+		{
+			if (random(seed) % 100 < _readRatio)
+			{
+				Locker<_MutexType>::lockShared(mutex);
+				std::uint64_t first = data[0], sum = 0;
+				for (auto value : data)
+					sum += value;
+				Locker<_MutexType>::unlockShared(mutex);
+
+				// 写者逐字递增，读者观察到的各字必然相等
+				if (sum != first * DATA_SIZE)
+					consistent.store(false, std::memory_order_relaxed);
+			}
+			else
+			{
+				auto timePoint = Clock::now();
+				mutex.lock();
+				auto wait = Clock::now() - timePoint;
+				for (auto& value : data)
+					++value;
+				mutex.unlock();
+
+				latency.push_back(static_cast<std::uint64_t>( \
+					std::chrono::duration_cast<Nanosecond>(wait).count()));
+			}
+			++count;
+		}
+		operations[_index] = count;
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(_threads);
+	for (std::size_t index = 0; index < _threads; ++index)
+		threads.emplace_back(execute, index);
+
+	while (ready.load() < _threads)
+		std::this_thread::yield();
+
+	auto timePoint = Clock::now();
+	start.store(true, std::memory_order_release);
+	std::this_thread::sleep_for(_duration);
+	stop.store(true, std::memory_order_relaxed);
+
+	for (auto& thread : threads)
+		thread.join();
+	auto elapsed = std::chrono::duration<double>(Clock::now() - timePoint).count();
+
+	std::vector<std::uint64_t> merged;
+	for (auto& latency : latencies)
+		merged.insert(merged.end(), latency.begin(), latency.end());
+	std::sort(merged.begin(), merged.end());
+
+	std::uint64_t total = 0;
+	for (auto count : operations)
+		total += count;
+
+	Result result;
+	result._throughput = total / elapsed;
+	result._writes = merged.size();
+	result._p50 = percentile(merged, 0.5);
+	result._p90 = percentile(merged, 0.9);
+	result._p99 = percentile(merged, 0.99);
+	result._p999 = percentile(merged, 0.999);
+	result._max = merged.empty() ? 0 : merged.back();
+	result._consistent = consistent.load() && data[0] == result._writes;
+	return result;
+}
+
+static void print(const char* _name, std::size_t _threads, \
+	unsigned _readRatio, const Result& _result)
+{
+	std::cout << std::left << std::setw(24) << _name \
+		<< std::right << std::setw(8) << _threads \
+		<< std::setw(6) << _readRatio << '/' << std::left << std::setw(4) << 100 - _readRatio \
+		<< std::right << std::setw(14) << static_cast<std::uint64_t>(_result._throughput) \
+		<< std::setw(10) << _result._writes \
+		<< std::setw(10) << _result._p50 \
+		<< std::setw(10) << _result._p90 \
+		<< std::setw(10) << _result._p99 \
+		<< std::setw(12) << _result._p999 \
+		<< std::setw(12) << _result._max \
+		<< (_result._consistent ? "" : "  INCONSISTENT") << std::endl;
+}
+
+template <typename _MutexType>
+static bool measure(const char* _name, std::size_t _threads, \
+	unsigned _readRatio, std::chrono::milliseconds _duration)
+{
+	auto result = run<_MutexType>(_threads, _readRatio, _duration);
+	print(_name, _threads, _readRatio, result);
+	return result._consistent;
+}
+
+int main(int _argc, char* _argv[])
+{
+	std::chrono::milliseconds duration(200);
+	if (_argc > 1)
+		duration = std::chrono::milliseconds(std::strtoul(_argv[1], nullptr, 10));
+
+	std::size_t maxThreads = std::thread::hardware_concurrency();
+	if (_argc > 2)
+		maxThreads = std::strtoul(_argv[2], nullptr, 10);
+	if (maxThreads <= 0)
+		maxThreads = 1;
+
+	std::vector<std::size_t> threadCounts;
+	for (std::size_t threads = 1; threads < maxThreads; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(maxThreads);
+
+	std::cout << std::left << std::setw(24) << "mutex" \
+		<< std::right << std::setw(8) << "threads" \
+		<< std::setw(11) << "read/write" \
+		<< std::setw(14) << "ops/s" \
+		<< std::setw(10) << "writes" \
+		<< std::setw(10) << "p50(ns)" \
+		<< std::setw(10) << "p90(ns)" \
+		<< std::setw(10) << "p99(ns)" \
+		<< std::setw(12) << "p99.9(ns)" \
+		<< std::setw(12) << "max(ns)" << std::endl;
+
+	bool consistent = true;
+	for (auto readRatio : READ_RATIOS)
+		for (auto threads : threadCounts)
+		{
+			consistent &= measure<SharedMutex>("SharedMutex", threads, readRatio, duration);
+			consistent &= measure<SharedTimedMutex>("SharedTimedMutex", threads, readRatio, duration);
+			consistent &= measure<DistributedSharedMutex>("DistributedSharedMutex", threads, readRatio, duration);
+			consistent &= measure<std::shared_mutex>("std::shared_mutex", threads, readRatio, duration);
+			consistent &= measure<std::mutex>("std::mutex", threads, readRatio, duration);
+		}
+
+	// 数据不一致则以非零状态退出，便于脚本检测回归
+	return consistent ? EXIT_SUCCESS : EXIT_FAILURE;
+}
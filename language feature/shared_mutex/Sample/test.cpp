@@ -1,18 +1,31 @@
 ﻿#define SHARED_MUTEX
 #define SHARED_TIMED_MUTEX
+//#define DISTRIBUTED_SHARED_MUTEX
+
+#ifdef DISTRIBUTED_SHARED_MUTEX
+#undef SHARED_TIMED_MUTEX
+#endif
 
 #include "Common.hpp"
 #include "System.h"
 #include "Version.hpp"
 
 #ifdef SHARED_MUTEX
+#include "SharedMutex.hpp"
 #include "shared_mutex.hpp"
 //#include <shared_mutex>
 #endif
 
+#ifdef DISTRIBUTED_SHARED_MUTEX
+#include "DistributedSharedMutex.hpp"
+#endif
+
+#include "SeqLock.hpp"
+
 #include <cstdlib>
 #include <cstddef>
 #include <queue>
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <mutex>
@@ -36,7 +49,9 @@ using SharedLock = std::lock_guard<_MutexType>;
 #endif
 
 #ifdef SHARED_MUTEX
-#ifdef SHARED_TIMED_MUTEX
+#if defined(DISTRIBUTED_SHARED_MUTEX)
+using MutexType = DistributedSharedMutex;
+#elif defined(SHARED_TIMED_MUTEX)
 using MutexType = std::shared_timed_mutex;
 #else
 using MutexType = std::shared_mutex;
@@ -83,7 +98,7 @@ static void sleepFor(Duration _duration)
 #endif
 }
 
-static NODISCARD std::size_t read()
+NODISCARD static std::size_t read()
 {
 	SharedLock<MutexType> lock(countMutex);
 	sleepFor(SLEEP_TIME);
@@ -91,7 +106,7 @@ static NODISCARD std::size_t read()
 	return 0;
 }
 
-static NODISCARD std::size_t write()
+NODISCARD static std::size_t write()
 {
 #ifdef DEDUCTION_GUIDE
 	std::lock_guard lock(countMutex);
@@ -103,7 +118,7 @@ static NODISCARD std::size_t write()
 	return ++exclusiveCounter;
 }
 
-static NODISCARD TaskType getTask()
+NODISCARD static TaskType getTask()
 {
 #ifdef DEDUCTION_GUIDE
 	std::lock_guard lock(queueMutex);
@@ -237,6 +252,123 @@ static void count()
 #endif
 }
 
+#ifdef SHARED_MUTEX
+/*
+ * 升级锁与共享锁并存，两个线程交替以升级锁读取计数，再升级为独占访问写回，或者降级为共享访问
+ * 升级锁之间互斥，并且升级期间没有其他独占访问插入，因此写回不会丢失更新；读者检查两份计数始终相等。
+ */
+static bool upgrade()
+{
+	constexpr std::size_t READERS = 4;
+	constexpr std::size_t UPGRADERS = 2;
+	constexpr std::size_t ROUNDS = 1000;
+
+	SharedMutex mutex;
+	std::size_t front = 0, back = 0;
+	std::atomic<bool> running(true), consistent(true);
+
+	auto read = [&]
+	{
+		while (running.load(std::memory_order_relaxed))
+		{
+			std::shared_lock<SharedMutex> lock(mutex);
+			if (front != back)
+				consistent.store(false, std::memory_order_relaxed);
+		}
+	};
+
+	auto upgrade = [&]
+	{
+		for (std::size_t round = 0; round < ROUNDS; ++round)
+		{
+			Eterfree::upgrade_lock<SharedMutex> lock(mutex);
+			auto value = front;
+
+			if (round % 2 == 0)
+			{
+				auto exclusive = lock.upgrade();
+				front = value + 1;
+				back = value + 1;
+			}
+			else
+			{
+				auto shared = lock.downgrade();
+				if (front != value || back != value)
+					consistent.store(false, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	std::thread readers[READERS], upgraders[UPGRADERS];
+	for (auto& thread : readers)
+		thread = std::thread(read);
+	for (auto& thread : upgraders)
+		thread = std::thread(upgrade);
+
+	for (auto& thread : upgraders)
+		thread.join();
+	running.store(false, std::memory_order_relaxed);
+	for (auto& thread : readers)
+		thread.join();
+
+	std::cout << front << ' ' << back << std::endl;
+	return consistent.load() && front == UPGRADERS * ROUNDS / 2;
+}
+#endif
+
+/*
+ * 写者交替以store与update修改多字数据，读者以两种load读取，检查各个字段始终一致
+ */
+static bool sequence()
+{
+	struct Point
+	{
+		std::size_t x, y, z;
+	};
+
+	constexpr std::size_t READERS = 4;
+	constexpr std::size_t ROUNDS = 100000;
+
+	SeqLock<Point> lock(Point{ 0, 0, 0 });
+	std::atomic<bool> running(true), consistent(true);
+
+	auto read = [&](bool _reference)
+	{
+		while (running.load(std::memory_order_relaxed))
+		{
+			Point point = { 0, 0, 0 };
+			if (_reference) lock.load(point);
+			else point = lock.load();
+
+			if (point.y != point.x * 2 || point.z != point.x * 3)
+				consistent.store(false, std::memory_order_relaxed);
+		}
+	};
+
+	std::thread readers[READERS];
+	for (std::size_t index = 0; index < READERS; ++index)
+		readers[index] = std::thread(read, index % 2 == 0);
+
+	for (std::size_t index = 1; index <= ROUNDS; ++index)
+		if (index % 2 == 0)
+			lock.store(Point{ index, index * 2, index * 3 });
+		else
+			lock.update([](Point& _point)
+				{
+					++_point.x;
+					_point.y = _point.x * 2;
+					_point.z = _point.x * 3;
+				});
+
+	running.store(false, std::memory_order_relaxed);
+	for (auto& thread : readers)
+		thread.join();
+
+	auto point = lock.load();
+	std::cout << point.x << ' ' << point.y << ' ' << point.z << std::endl;
+	return consistent.load() && point.x == ROUNDS;
+}
+
 int main()
 {
 	constexpr auto SIZE = TOTAL_SIZE / EXCLUSIVE_SIZE;
@@ -272,6 +404,14 @@ int main()
 	std::cout << sharedCounter << ' ' \
 		<< exclusiveCounter << std::endl;
 
+#ifdef SHARED_MUTEX
+	std::cout << std::boolalpha \
+		<< upgrade() << std::endl;
+#endif
+
+	std::cout << std::boolalpha \
+		<< sequence() << std::endl;
+
 	delete[] threadPool;
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,98 @@
+﻿#pragma once
+
+#include "Compiler.h"
+#include "Common.hpp"
+
+#include <cstddef>
+#include <atomic>
+#include <thread>
+
+#if defined(COMPILER_MSVC) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#endif
+
+// 默认的自旋轮数上限，为零则不自旋
+#ifndef ETERFREE_SPIN_ROUNDS
+#define ETERFREE_SPIN_ROUNDS 10
+#endif
+
+/*
+ * 自适应自旋
+ * 阻塞线程之前先自旋等待，每轮检查条件之前暂停处理器，暂停次数逐轮指数增加。
+ * 自旋期间条件满足则放宽自旋轮数，否则收紧自旋轮数，轮数不超过配置的上限。
+ * 临界区较短之时，自旋可以避免系统调用与上下文切换。
+ */
+class AdaptiveSpin
+{
+	// 单轮暂停次数上限
+	static constexpr std::size_t PAUSE_MAX = 64;
+
+private:
+	std::atomic<std::size_t> _rounds;
+	std::atomic<std::size_t> _limit;
+
+public:
+	// 暂停处理器，降低自旋的功耗与对同一核心其他超线程的干扰
+	static void pause() noexcept
+	{
+#if defined(COMPILER_MSVC) && (defined(_M_IX86) || defined(_M_X64))
+		_mm_pause();
+#elif (defined(COMPILER_GCC) || defined(COMPILER_CLANG)) \
+	&& (defined(__i386__) || defined(__x86_64__))
+		__builtin_ia32_pause();
+#elif (defined(COMPILER_GCC) || defined(COMPILER_CLANG)) \
+	&& (defined(__aarch64__) || defined(__arm__))
+		__asm__ __volatile__("yield");
+#else
+		std::this_thread::yield();
+#endif
+	}
+
+public:
+	explicit AdaptiveSpin(std::size_t _limit = ETERFREE_SPIN_ROUNDS) noexcept : \
+		_rounds(_limit), _limit(_limit) {}
+
+	AdaptiveSpin(const AdaptiveSpin&) = delete;
+
+	AdaptiveSpin& operator=(const AdaptiveSpin&) = delete;
+
+	NODISCARD std::size_t getLimit() const noexcept
+	{
+		return _limit.load(std::memory_order_relaxed);
+	}
+
+	void setLimit(std::size_t _limit) noexcept
+	{
+		this->_limit.store(_limit, std::memory_order_relaxed);
+		_rounds.store(_limit, std::memory_order_relaxed);
+	}
+
+	// 自旋直至谓词成立或者轮数耗尽，返回谓词是否成立
+	template <typename _Predicate>
+	NODISCARD bool spin(_Predicate&& _predicate);
+};
+
+template <typename _Predicate>
+bool AdaptiveSpin::spin(_Predicate&& _predicate)
+{
+	auto rounds = _rounds.load(std::memory_order_relaxed);
+	for (std::size_t round = 0, count = 1; round < rounds; ++round)
+	{
+		for (std::size_t index = 0; index < count; ++index)
+			pause();
+
+		if (_predicate())
+		{
+			if (rounds < _limit.load(std::memory_order_relaxed))
+				_rounds.store(rounds + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		if (count < PAUSE_MAX) count *= 2;
+	}
+
+	// 至少保留一轮，以便恢复自旋
+	if (rounds > 1)
+		_rounds.store(rounds - 1, std::memory_order_relaxed);
+	return false;
+}
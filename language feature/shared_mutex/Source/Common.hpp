@@ -64,7 +64,7 @@ namespace std
 	//}
 
 	template <typename _Type, const size_t _SIZE>
-	NODISCARD constexpr auto size(_Type(&_array)[_SIZE]) noexcept
+	NODISCARD constexpr size_t size(_Type(&_array)[_SIZE]) noexcept
 	{
 		return _SIZE;
 	}
@@ -72,7 +72,7 @@ namespace std
 
 #ifndef __cpp_lib_ssize
 	template <typename _Type, const ptrdiff_t _SIZE>
-	NODISCARD constexpr auto ssize(_Type(&_array)[_SIZE]) noexcept
+	NODISCARD constexpr ptrdiff_t ssize(_Type(&_array)[_SIZE]) noexcept
 	{
 		return _SIZE;
 	}
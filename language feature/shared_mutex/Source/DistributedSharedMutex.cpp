@@ -0,0 +1,121 @@
+﻿#include "DistributedSharedMutex.hpp"
+
+#include <new>
+#include <thread>
+
+std::size_t DistributedSharedMutex::getTicket() noexcept
+{
+	static std::atomic<std::size_t> counter(0);
+	thread_local std::size_t ticket = \
+		counter.fetch_add(1, std::memory_order_relaxed);
+	return ticket;
+}
+
+bool DistributedSharedMutex::unshared() const noexcept
+{
+	for (std::size_t index = 0; index <= _mask; ++index)
+		if (_slots[index]._counter.load() > 0)
+			return false;
+	return true;
+}
+
+std::size_t DistributedSharedMutex::getDefaultSize() noexcept
+{
+	auto size = static_cast<std::size_t>(std::thread::hardware_concurrency());
+	return size > DEFAULT_SIZE ? size : DEFAULT_SIZE;
+}
+
+DistributedSharedMutex::DistributedSharedMutex(std::size_t _size) : \
+	_mask(0), _slots(nullptr), _exclusive(false), _sleepers(0)
+{
+	if (_size <= 0) _size = getDefaultSize();
+
+	std::size_t size = 1;
+	while (size < _size && size < MAX_SIZE) size <<= 1;
+	_mask = size - 1;
+
+	// C++17之前new不保证超过基础对齐的对齐要求，多分配一个槽位，手动对齐至缓存行
+	auto space = (size + 1) * sizeof(Slot);
+	_storage.reset(new unsigned char[space]);
+
+	void* pointer = _storage.get();
+	std::align(alignof(Slot), size * sizeof(Slot), pointer, space);
+	_slots = static_cast<Slot*>(pointer);
+
+	for (std::size_t index = 0; index < size; ++index)
+		new (_slots + index) Slot();
+}
+
+void DistributedSharedMutex::notify(std::condition_variable& _queue, bool _all)
+{
+	if (_sleepers.load() <= 0) return;
+
+	_mutex.lock();
+	_mutex.unlock();
+
+	if (_all) _queue.notify_all();
+	else _queue.notify_one();
+}
+
+void DistributedSharedMutex::release(Slot& _slot)
+{
+	_slot._counter.fetch_sub(1);
+	if (_exclusive.load())
+		notify(_singleQueue, false);
+}
+
+void DistributedSharedMutex::lock()
+{
+	// 设置独占标志，阻塞后续共享访问
+	auto exclusive = [this] { return !_exclusive.load(); };
+	for (bool flag = false; \
+		!_exclusive.compare_exchange_weak(flag, true); flag = false)
+		wait(_batchQueue, exclusive);
+
+	// 等待所有槽位的共享访问结束
+	wait(_singleQueue, [this] { return unshared(); });
+}
+
+bool DistributedSharedMutex::try_lock()
+{
+	bool flag = false;
+	if (!_exclusive.compare_exchange_strong(flag, true))
+		return false;
+
+	if (unshared()) return true;
+
+	_exclusive.store(false);
+	notify(_batchQueue, true);
+	return false;
+}
+
+void DistributedSharedMutex::unlock()
+{
+	_exclusive.store(false);
+	notify(_batchQueue, true);
+}
+
+void DistributedSharedMutex::lock_shared()
+{
+	auto& slot = getSlot();
+	auto exclusive = [this] { return !_exclusive.load(); };
+	while (true)
+	{
+		// 先增加本地计数再检查独占标志，与独占访问的顺序相反，确保至少一方观察到另一方
+		slot._counter.fetch_add(1);
+		if (!_exclusive.load()) return;
+
+		release(slot);
+		wait(_batchQueue, exclusive);
+	}
+}
+
+bool DistributedSharedMutex::try_lock_shared()
+{
+	auto& slot = getSlot();
+	slot._counter.fetch_add(1);
+	if (!_exclusive.load()) return true;
+
+	release(slot);
+	return false;
+}
@@ -0,0 +1,108 @@
+﻿#pragma once
+
+#include "Common.hpp"
+
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+/*
+ * 分布式共享互斥元
+ * 共享计数分散至多个独占缓存行的槽位，每个线程固定使用一个槽位，共享锁定与解锁只访问本地缓存行。
+ * 独占访问先设置独占标志，阻塞后续共享访问，再逐个等待所有槽位的共享计数归零。
+ * 适用于读多写少的场景，独占锁定的代价随槽位数量线性增长，并且每个对象占用较多内存。
+ * 槽位按线程而非处理器分配，以免线程迁移之后在其他槽位解锁。
+ * 槽位数量默认为硬件线程数量，至少DEFAULT_SIZE，向上取整至二的幂，读者线程数量不超过槽位数量则各自独占槽位。
+ */
+class DistributedSharedMutex
+{
+	static constexpr std::size_t CACHE_LINE = 64;
+
+	// 默认槽位数量的下限，以及槽位数量的上限
+	static constexpr std::size_t DEFAULT_SIZE = 64;
+	static constexpr std::size_t MAX_SIZE = 65536;
+
+	struct alignas(CACHE_LINE) Slot
+	{
+		std::atomic<std::size_t> _counter;
+
+		Slot() : _counter(0) {}
+	};
+
+private:
+	// 槽位数量为二的幂，以掩码代替取模
+	std::size_t _mask;
+	std::unique_ptr<unsigned char[]> _storage;
+	Slot* _slots;
+
+	std::atomic<bool> _exclusive;
+
+	// 以条件变量阻塞的线程数量，通知之前检查，无人阻塞则无需锁定互斥元
+	std::atomic<std::size_t> _sleepers;
+
+	std::mutex _mutex;
+	std::condition_variable _singleQueue;
+	std::condition_variable _batchQueue;
+
+private:
+	// 线程首次访问之时领取序号，各互斥元以序号的低位选择槽位，从而轮流分配
+	static std::size_t getTicket() noexcept;
+
+	Slot& getSlot() noexcept
+	{
+		return _slots[getTicket() & _mask];
+	}
+
+	NODISCARD bool unshared() const noexcept;
+
+	template <typename _Predicate>
+	void wait(std::condition_variable& _queue, _Predicate _predicate);
+
+	void notify(std::condition_variable& _queue, bool _all);
+
+	// 撤销共享计数，独占访问等待之时唤醒
+	void release(Slot& _slot);
+
+public:
+	static std::size_t getDefaultSize() noexcept;
+
+	// 指定槽位数量，向上取整至二的幂，至多MAX_SIZE；若为零则采用默认数量
+	explicit DistributedSharedMutex(std::size_t _size = 0);
+
+	DistributedSharedMutex(const DistributedSharedMutex&) = delete;
+
+	DistributedSharedMutex& operator=(const DistributedSharedMutex&) = delete;
+
+	NODISCARD std::size_t size() const noexcept
+	{
+		return _mask + 1;
+	}
+
+	void lock();
+
+	NODISCARD bool try_lock();
+
+	void unlock();
+
+	void lock_shared();
+
+	NODISCARD bool try_lock_shared();
+
+	void unlock_shared()
+	{
+		release(getSlot());
+	}
+};
+
+template <typename _Predicate>
+void DistributedSharedMutex::wait(std::condition_variable& _queue, _Predicate _predicate)
+{
+	if (_predicate()) return;
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_sleepers.fetch_add(1);
+	_queue.wait(lock, _predicate);
+	_sleepers.fetch_sub(1);
+}
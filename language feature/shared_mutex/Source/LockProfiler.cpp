@@ -0,0 +1,216 @@
+﻿#include "LockProfiler.hpp"
+
+#ifdef ETERFREE_LOCK_PROFILER
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <utility>
+
+namespace
+{
+	// 全局注册表，首个分析器构造之时创建，因此晚于所有分析器析构
+	struct Registry
+	{
+		std::mutex _mutex;
+		std::vector<LockProfiler*> _profilers;
+	};
+
+	Registry& getRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	// 当前线程持有的共享访问及其开始持有的时刻
+	using Holder = std::pair<const LockProfiler*, LockProfiler::TimePoint>;
+
+	std::vector<Holder>& getHolders()
+	{
+		thread_local std::vector<Holder> holders;
+		return holders;
+	}
+
+	void print(std::ostream& _stream, const char* _mode, \
+		const LockProfiler::Statistics& _statistics)
+	{
+		auto average = [](std::uint64_t _total, std::uint64_t _count)
+		{
+			return _count > 0 ? _total / _count : 0;
+		};
+
+		_stream << "  " << _mode \
+			<< ": acquisitions " << _statistics._acquisitions \
+			<< ", contentions " << _statistics._contentions \
+			<< ", wait(ns) total " << _statistics._totalWait \
+			<< " avg " << average(_statistics._totalWait, _statistics._contentions) \
+			<< " max " << _statistics._maxWait \
+			<< ", hold(ns) total " << _statistics._totalHold \
+			<< " avg " << average(_statistics._totalHold, _statistics._acquisitions) \
+			<< " max " << _statistics._maxHold << '\n';
+	}
+}
+
+auto LockProfiler::Counter::load() const noexcept -> Statistics
+{
+	Statistics statistics;
+	statistics._acquisitions = _acquisitions.load(std::memory_order_relaxed);
+	statistics._contentions = _contentions.load(std::memory_order_relaxed);
+	statistics._totalWait = _totalWait.load(std::memory_order_relaxed);
+	statistics._maxWait = _maxWait.load(std::memory_order_relaxed);
+	statistics._totalHold = _totalHold.load(std::memory_order_relaxed);
+	statistics._maxHold = _maxHold.load(std::memory_order_relaxed);
+	return statistics;
+}
+
+void LockProfiler::Counter::reset() noexcept
+{
+	_acquisitions.store(0, std::memory_order_relaxed);
+	_contentions.store(0, std::memory_order_relaxed);
+	_totalWait.store(0, std::memory_order_relaxed);
+	_maxWait.store(0, std::memory_order_relaxed);
+	_totalHold.store(0, std::memory_order_relaxed);
+	_maxHold.store(0, std::memory_order_relaxed);
+}
+
+void LockProfiler::update(std::atomic<std::uint64_t>& _maximum, \
+	std::uint64_t _value) noexcept
+{
+	auto maximum = _maximum.load(std::memory_order_relaxed);
+	while (maximum < _value \
+		&& !_maximum.compare_exchange_weak(maximum, _value, \
+			std::memory_order_relaxed, std::memory_order_relaxed));
+}
+
+auto LockProfiler::snapshot() -> std::vector<Record>
+{
+	auto& registry = getRegistry();
+	std::lock_guard<std::mutex> lock(registry._mutex);
+
+	std::vector<Record> records;
+	records.reserve(registry._profilers.size());
+	for (auto profiler : registry._profilers)
+	{
+		Record record;
+		record._name = profiler->_name;
+		record._shared = profiler->_shared.load();
+		record._exclusive = profiler->_exclusive.load();
+		records.push_back(std::move(record));
+	}
+	return records;
+}
+
+void LockProfiler::dump(std::ostream& _stream)
+{
+	for (const auto& record : snapshot())
+	{
+		_stream << record._name << '\n';
+		print(_stream, "shared", record._shared);
+		print(_stream, "exclusive", record._exclusive);
+	}
+}
+
+void LockProfiler::resetAll() noexcept
+{
+	auto& registry = getRegistry();
+	std::lock_guard<std::mutex> lock(registry._mutex);
+	for (auto profiler : registry._profilers)
+		profiler->reset();
+}
+
+LockProfiler::LockProfiler() : \
+	_holdTime(0)
+{
+	auto& registry = getRegistry();
+	std::lock_guard<std::mutex> lock(registry._mutex);
+	_name = "SharedMutex@" + std::to_string(registry._profilers.size());
+	registry._profilers.push_back(this);
+}
+
+LockProfiler::~LockProfiler()
+{
+	auto& registry = getRegistry();
+	std::lock_guard<std::mutex> lock(registry._mutex);
+	auto& profilers = registry._profilers;
+	profilers.erase(std::remove(profilers.begin(), profilers.end(), this), \
+		profilers.end());
+}
+
+std::string LockProfiler::getName() const
+{
+	std::lock_guard<std::mutex> lock(getRegistry()._mutex);
+	return _name;
+}
+
+void LockProfiler::setName(const std::string& _name)
+{
+	std::lock_guard<std::mutex> lock(getRegistry()._mutex);
+	this->_name = _name;
+}
+
+auto LockProfiler::load() const -> Record
+{
+	Record record;
+	record._name = getName();
+	record._shared = _shared.load();
+	record._exclusive = _exclusive.load();
+	return record;
+}
+
+void LockProfiler::reset() noexcept
+{
+	_shared.reset();
+	_exclusive.reset();
+}
+
+void LockProfiler::acquire(Mode _mode, TimePoint _begin, bool _contended) noexcept
+{
+	auto time = now();
+	auto& counter = getCounter(_mode);
+	counter._acquisitions.fetch_add(1, std::memory_order_relaxed);
+
+	if (_contended)
+	{
+		auto wait = elapse(_begin, time);
+		counter._contentions.fetch_add(1, std::memory_order_relaxed);
+		counter._totalWait.fetch_add(wait, std::memory_order_relaxed);
+		update(counter._maxWait, wait);
+	}
+
+	// 线程局部表分配内存失败则放弃统计本次持有时长
+	if (_mode == Mode::SHARED)
+	{
+		try
+		{
+			getHolders().emplace_back(this, time);
+		}
+		catch (...) {}
+	}
+	else
+		_holdTime.store(time.time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+void LockProfiler::release(Mode _mode) noexcept
+{
+	auto time = now();
+	TimePoint begin;
+
+	if (_mode == Mode::SHARED)
+	{
+		// 从后向前查找，通常最近获取的共享访问最先释放
+		auto& holders = getHolders();
+		auto iterator = std::find_if(holders.rbegin(), holders.rend(), \
+			[this](const Holder& _holder) { return _holder.first == this; });
+		if (iterator == holders.rend()) return;
+
+		begin = iterator->second;
+		holders.erase(std::next(iterator).base());
+	}
+	else
+		begin = TimePoint(TimePoint::duration(_holdTime.load(std::memory_order_relaxed)));
+
+	auto hold = elapse(begin, time);
+	auto& counter = getCounter(_mode);
+	counter._totalHold.fetch_add(hold, std::memory_order_relaxed);
+	update(counter._maxHold, hold);
+}
+#endif
@@ -0,0 +1,149 @@
+﻿#pragma once
+
+#include "Common.hpp"
+
+/*
+ * 定义宏ETERFREE_LOCK_PROFILER以启用锁竞争分析，否则所有插桩宏展开为空，不产生任何代码与数据。
+ */
+#ifdef ETERFREE_LOCK_PROFILER
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ * 锁竞争分析器
+ * 每个互斥元持有一个分析器，按共享访问与独占访问分别统计获取次数、竞争次数、等待时长与持有时长，升级访问计入独占访问。
+ * 所有分析器登记于全局注册表，可以随时汇总或者输出，以便定位竞争激烈的互斥元。
+ * 独占访问至多一个持有者，以成员记录开始持有的时刻；共享访问以线程局部表记录每个互斥元开始持有的时刻。
+ */
+class LockProfiler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+	using TimePoint = Clock::time_point;
+	using Nanosecond = std::chrono::nanoseconds;
+
+	enum class Mode : std::uint8_t
+	{
+		SHARED, EXCLUSIVE
+	};
+
+	// 统计快照，时长单位为纳秒
+	struct Statistics
+	{
+		std::uint64_t _acquisitions;
+		std::uint64_t _contentions;
+		std::uint64_t _totalWait;
+		std::uint64_t _maxWait;
+		std::uint64_t _totalHold;
+		std::uint64_t _maxHold;
+	};
+
+	struct Record
+	{
+		std::string _name;
+		Statistics _shared;
+		Statistics _exclusive;
+	};
+
+private:
+	struct Counter
+	{
+		std::atomic<std::uint64_t> _acquisitions;
+		std::atomic<std::uint64_t> _contentions;
+		std::atomic<std::uint64_t> _totalWait;
+		std::atomic<std::uint64_t> _maxWait;
+		std::atomic<std::uint64_t> _totalHold;
+		std::atomic<std::uint64_t> _maxHold;
+
+		Counter() : _acquisitions(0), _contentions(0), \
+			_totalWait(0), _maxWait(0), _totalHold(0), _maxHold(0) {}
+
+		NODISCARD Statistics load() const noexcept;
+
+		void reset() noexcept;
+	};
+
+private:
+	Counter _shared;
+	Counter _exclusive;
+
+	// 独占访问开始持有的时刻
+	std::atomic<TimePoint::rep> _holdTime;
+
+	// 由注册表的互斥元保护
+	std::string _name;
+
+private:
+	static void update(std::atomic<std::uint64_t>& _maximum, \
+		std::uint64_t _value) noexcept;
+
+	static std::uint64_t elapse(TimePoint _begin, TimePoint _end) noexcept
+	{
+		auto duration = std::chrono::duration_cast<Nanosecond>(_end - _begin).count();
+		return duration > 0 ? static_cast<std::uint64_t>(duration) : 0;
+	}
+
+	Counter& getCounter(Mode _mode) noexcept
+	{
+		return _mode == Mode::SHARED ? _shared : _exclusive;
+	}
+
+public:
+	static TimePoint now() noexcept
+	{
+		return Clock::now();
+	}
+
+	// 汇总所有登记的分析器
+	static std::vector<Record> snapshot();
+
+	// 以文本格式输出所有登记的分析器
+	static void dump(std::ostream& _stream);
+
+	// 清零所有登记的分析器
+	static void resetAll() noexcept;
+
+public:
+	LockProfiler();
+
+	LockProfiler(const LockProfiler&) = delete;
+
+	~LockProfiler();
+
+	LockProfiler& operator=(const LockProfiler&) = delete;
+
+	NODISCARD std::string getName() const;
+
+	void setName(const std::string& _name);
+
+	NODISCARD Record load() const;
+
+	void reset() noexcept;
+
+	// 获取成功之后调用，_begin为开始获取的时刻，_contended表示未能立即获取
+	void acquire(Mode _mode, TimePoint _begin, bool _contended) noexcept;
+
+	// 释放之前调用
+	void release(Mode _mode) noexcept;
+};
+
+#define ETERFREE_PROFILE_BEGIN(time) \
+	auto time = LockProfiler::now()
+#define ETERFREE_PROFILE_ACQUIRE(profiler, mode, time, contended) \
+	(profiler).acquire(LockProfiler::Mode::mode, time, contended)
+#define ETERFREE_PROFILE_RELEASE(profiler, mode) \
+	(profiler).release(LockProfiler::Mode::mode)
+
+#else
+#define ETERFREE_PROFILE_BEGIN(time) \
+	static_cast<void>(0)
+#define ETERFREE_PROFILE_ACQUIRE(profiler, mode, time, contended) \
+	static_cast<void>(contended)
+#define ETERFREE_PROFILE_RELEASE(profiler, mode) \
+	static_cast<void>(0)
+#endif
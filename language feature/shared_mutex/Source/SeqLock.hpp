@@ -0,0 +1,144 @@
+﻿#pragma once
+
+#include "Common.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+/*
+ * 顺序锁
+ * 写者递增序号至奇数，修改数据，再递增序号至偶数；读者先后读取序号与数据，序号为奇数或者前后不一致则重试。
+ * 读者从不写入共享内存，适用于频繁读取、很少修改的小型数据。
+ * 数据以原子变量按字存储，读者与写者并发访问不构成数据竞争，因此要求数据类型可平凡复制；
+ * 读取之时以对齐的原始存储接收数据，不要求数据类型可默认构造。
+ * 写者之间以互斥元同步。
+ */
+template <typename _Type>
+class SeqLock
+{
+	static_assert(std::is_trivially_copyable<_Type>::value, \
+		"The value type of a sequence lock must be trivially copyable.");
+
+public:
+	using Type = _Type;
+
+private:
+	using Word = std::size_t;
+
+	static constexpr std::size_t WORD_SIZE = \
+		(sizeof(Type) + sizeof(Word) - 1) / sizeof(Word);
+
+private:
+	std::atomic<std::size_t> _sequence;
+	std::atomic<Word> _words[WORD_SIZE];
+	std::mutex _mutex;
+
+private:
+	/*
+	 * 写者持有写者锁之时调用，读取结果即为当前数据；
+	 * 读者于load之中乐观调用，不持有锁，读取结果可能与写者交错，须再次比较序号，不一致则丢弃。
+	 */
+	void read(Word(&_buffer)[WORD_SIZE]) const noexcept
+	{
+		for (std::size_t index = 0; index < WORD_SIZE; ++index)
+			_buffer[index] = _words[index].load(std::memory_order_relaxed);
+	}
+
+	// 持有写者锁之时调用
+	void write(const Type& _value) noexcept;
+
+	// 读取一致的数据，复制至指定的存储空间
+	void copy(void* _value) const noexcept;
+
+public:
+	SeqLock() : _sequence(0)
+	{
+		for (auto& word : _words)
+			word.store(0, std::memory_order_relaxed);
+	}
+
+	explicit SeqLock(const Type& _value) : SeqLock()
+	{
+		Word buffer[WORD_SIZE] = {};
+		std::memcpy(buffer, &_value, sizeof(Type));
+		for (std::size_t index = 0; index < WORD_SIZE; ++index)
+			_words[index].store(buffer[index], std::memory_order_relaxed);
+	}
+
+	SeqLock(const SeqLock&) = delete;
+
+	SeqLock& operator=(const SeqLock&) = delete;
+
+	// 读取数据，写者修改期间自旋重试
+	void load(Type& _value) const noexcept
+	{
+		copy(&_value);
+	}
+
+	NODISCARD Type load() const noexcept
+	{
+		alignas(Type) unsigned char storage[sizeof(Type)];
+		copy(storage);
+		return *reinterpret_cast<const Type*>(storage);
+	}
+
+	void store(const Type& _value)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		write(_value);
+	}
+
+	// 在写者锁保护之下读取、修改并且写回数据
+	template <typename _Function>
+	void update(_Function&& _function)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		Word buffer[WORD_SIZE];
+		read(buffer);
+
+		alignas(Type) unsigned char storage[sizeof(Type)];
+		std::memcpy(storage, buffer, sizeof(Type));
+
+		auto& value = *reinterpret_cast<Type*>(storage);
+		_function(value);
+		write(value);
+	}
+};
+
+template <typename _Type>
+void SeqLock<_Type>::write(const Type& _value) noexcept
+{
+	Word buffer[WORD_SIZE] = {};
+	std::memcpy(buffer, &_value, sizeof(Type));
+
+	auto sequence = _sequence.load(std::memory_order_relaxed);
+	_sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	for (std::size_t index = 0; index < WORD_SIZE; ++index)
+		_words[index].store(buffer[index], std::memory_order_relaxed);
+
+	_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+template <typename _Type>
+void SeqLock<_Type>::copy(void* _value) const noexcept
+{
+	Word buffer[WORD_SIZE];
+	std::size_t sequence;
+	do
+	{
+		while ((sequence = _sequence.load(std::memory_order_acquire)) & 1)
+			std::this_thread::yield();
+
+		read(buffer);
+		std::atomic_thread_fence(std::memory_order_acquire);
+	} while (_sequence.load(std::memory_order_relaxed) != sequence);
+
+	std::memcpy(_value, buffer, sizeof(Type));
+}
@@ -1,89 +1,195 @@
 #include "SharedMutex.hpp"
 
-#ifdef ETERFREE_SHARED_MUTEX
-#include <cstdint>
-#endif
-
-#ifdef ETERFREE_SHARED_MUTEX
 bool SharedMutex::tryLock() noexcept
 {
-	if (_flag || _counter > 0)
-		return false;
-	return _flag = true;
+	std::size_t state = 0;
+	return _state.compare_exchange_strong(state, EXCLUSIVE, \
+		std::memory_order_acquire, std::memory_order_relaxed);
 }
 
 bool SharedMutex::tryLockShared() noexcept
 {
-	if (_flag || _counter == SIZE_MAX)
-		return false;
+	auto state = _state.load(std::memory_order_relaxed);
+	while (shareable(state))
+		if (_state.compare_exchange_weak(state, state + 1, \
+			std::memory_order_acquire, std::memory_order_relaxed))
+			return true;
+	return false;
+}
 
-	++_counter;
-	return true;
+bool SharedMutex::tryLockUpgrade() noexcept
+{
+	auto state = _state.load(std::memory_order_relaxed);
+	while (exclusive(state))
+		if (_state.compare_exchange_weak(state, state | UPGRADE, \
+			std::memory_order_acquire, std::memory_order_relaxed))
+			return true;
+	return false;
 }
 
-SharedMutex::SharedMutex() : \
-	_counter(0), _flag(false)
+void SharedMutex::notify(Queue& _queue, bool _all)
 {
-	_exclusive = [this]
-	{
-		return !_flag;
-	};
+	if (_queue._waiters.load() <= 0) return;
 
-	_unshared = [this]
-	{
-		return _counter == 0;
-	};
+#ifdef ETERFREE_ATOMIC_WAIT
+	_queue._epoch.fetch_add(1);
+	if (_all) _queue._epoch.notify_all();
+	else _queue._epoch.notify_one();
+#endif
+
+	if (_queue._sleepers.load() <= 0) return;
+
+	_mutex.lock();
+	_mutex.unlock();
+
+	if (_all) _queue._condition.notify_all();
+	else _queue._condition.notify_one();
+}
+
+void SharedMutex::handoff()
+{
+	if (_writerQueue._waiters.load() > 0)
+		notify(_writerQueue, false);
+	else
+		notify(_batchQueue, true);
+}
 
-	_shareable = [this]
+void SharedMutex::acquire(std::size_t _flag)
+{
+	auto state = _state.load(std::memory_order_relaxed);
+	while (true)
 	{
-		return !_flag \
-			&& _counter < SIZE_MAX;
-	};
+		if (!exclusive(state))
+		{
+			wait(_writerQueue, exclusive);
+			state = _state.load(std::memory_order_relaxed);
+			continue;
+		}
+
+		if (_state.compare_exchange_weak(state, state | _flag, \
+			std::memory_order_acquire, std::memory_order_relaxed))
+			break;
+	}
+
+	// ʲų⹲ʣתδѵĹ
+	if (_flag == UPGRADE)
+		notify(_batchQueue, true);
+}
+
+void SharedMutex::release() noexcept
+{
+	auto state = _state.fetch_sub(1);
+	if ((state & EXCLUSIVE) != 0 && (state & SHARED_MASK) == 1)
+		notify(_singleQueue, false);
+	else if ((state & SHARED_MASK) == SHARED_MAX)
+		notify(_batchQueue, true);
 }
 
 void SharedMutex::lock()
 {
-	std::unique_lock<std::mutex> lock(_mutex);
-	_batchQueue.wait(lock, _exclusive);
+	ETERFREE_PROFILE_BEGIN(time);
+	bool contended = !tryLock();
+	if (contended)
+	{
+		// öռ־
+		acquire(EXCLUSIVE);
 
-	_flag = true;
+		// ȴʽ
+		wait(_singleQueue, unshared);
+	}
 
-	_singleQueue.wait(lock, _unshared);
+	ETERFREE_PROFILE_ACQUIRE(_profiler, EXCLUSIVE, time, contended);
 }
 
-void SharedMutex::unlock()
+bool SharedMutex::try_lock() noexcept
 {
-	_mutex.lock();
-	_flag = false;
-	_mutex.unlock();
+	ETERFREE_PROFILE_BEGIN(time);
+	if (!tryLock()) return false;
+
+	ETERFREE_PROFILE_ACQUIRE(_profiler, EXCLUSIVE, time, false);
+	return true;
+}
 
-	_batchQueue.notify_all();
+void SharedMutex::unlock()
+{
+	ETERFREE_PROFILE_RELEASE(_profiler, EXCLUSIVE);
+	_state.fetch_and(~EXCLUSIVE);
+	handoff();
 }
 
 void SharedMutex::lock_shared()
 {
-	std::unique_lock<std::mutex> lock(_mutex);
-	_batchQueue.wait(lock, _shareable);
+	ETERFREE_PROFILE_BEGIN(time);
+	bool contended = false;
+	while (true)
+	{
+		// ·ֻһԭӼӷռ־߹
+		auto state = _state.fetch_add(1, std::memory_order_acquire);
+		if (shareable(state)) break;
 
-	++_counter;
+		contended = true;
+		release();
+		wait(_batchQueue, shareable);
+	}
+
+	ETERFREE_PROFILE_ACQUIRE(_profiler, SHARED, time, contended);
+}
+
+bool SharedMutex::try_lock_shared() noexcept
+{
+	ETERFREE_PROFILE_BEGIN(time);
+	if (!tryLockShared()) return false;
+
+	ETERFREE_PROFILE_ACQUIRE(_profiler, SHARED, time, false);
+	return true;
 }
 
 void SharedMutex::unlock_shared()
 {
-	_mutex.lock();
-	auto count = _counter--;
-	auto exclusive = _flag;
-	_mutex.unlock();
+	ETERFREE_PROFILE_RELEASE(_profiler, SHARED);
+	release();
+}
 
-	if (exclusive)
-	{
-		if (count == 1)
-			_singleQueue.notify_one();
-	}
-	else
-	{
-		if (count == SIZE_MAX)
-			_batchQueue.notify_all();
-	}
+// ʼռ
+void SharedMutex::lock_upgrade()
+{
+	ETERFREE_PROFILE_BEGIN(time);
+	bool contended = !tryLockUpgrade();
+	if (contended) acquire(UPGRADE);
+
+	ETERFREE_PROFILE_ACQUIRE(_profiler, EXCLUSIVE, time, contended);
+}
+
+bool SharedMutex::try_lock_upgrade() noexcept
+{
+	ETERFREE_PROFILE_BEGIN(time);
+	if (!tryLockUpgrade()) return false;
+
+	ETERFREE_PROFILE_ACQUIRE(_profiler, EXCLUSIVE, time, false);
+	return true;
+}
+
+void SharedMutex::unlock_upgrade()
+{
+	ETERFREE_PROFILE_RELEASE(_profiler, EXCLUSIVE);
+	_state.fetch_and(~UPGRADE);
+	handoff();
+}
+
+void SharedMutex::unlock_upgrade_and_lock()
+{
+	// ־֮ʱڶռ־һԭӼӷ־öռ־
+	_state.fetch_add(EXCLUSIVE - UPGRADE, std::memory_order_acquire);
+	wait(_singleQueue, unshared);
+}
+
+void SharedMutex::unlock_upgrade_and_lock_shared()
+{
+	ETERFREE_PROFILE_RELEASE(_profiler, EXCLUSIVE);
+
+	// һԭӼ־ӹ
+	_state.fetch_sub(UPGRADE - 1);
+	handoff();
+
+	ETERFREE_PROFILE_ACQUIRE(_profiler, SHARED, LockProfiler::now(), false);
 }
-#endif
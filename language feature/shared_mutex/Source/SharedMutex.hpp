@@ -11,22 +11,22 @@
 #define ETERFREE_SHARED_MUTEX
 #endif
 
-#if defined(ETERFREE_SHARED_MUTEX) || defined(ETERFREE_SHARED_TIMED_MUTEX)
 #include "Common.hpp"
-#endif
+#include "AdaptiveSpin.hpp"
+#include "LockProfiler.hpp"
 
-#ifdef ETERFREE_SHARED_MUTEX
 #include <cstddef>
-#include <functional>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
-#endif
 
-#ifdef ETERFREE_SHARED_TIMED_MUTEX
-#include <chrono>
+// ֧ԭӵȴԭӱ̣߳߳
+#ifdef __cpp_lib_atomic_wait
+#define ETERFREE_ATOMIC_WAIT
 #endif
 
-#ifdef ETERFREE_SHARED_MUTEX
 // std::mutexһ̱߳һ̱߳ͷ
 //class SharedMutex
 //{
@@ -40,29 +40,120 @@
 //		_counter(0) {}
 //}
 
+/*
+ * Ԫ
+ * һԭӱ¼״̬λΪռ־θλΪ־λΪ
+ * ޾֮ʱֻһԭӼӼռֻһαȽϺͽһԭӲ
+ * ռöռ־ʣٵȴйʽӶ⹲ռռʡ
+ * ȴ֮ʱӦδ̡߳
+ * ʡռȴʽĶռʷֱŶӣԼ¼ȴ߳˵ȴ֪ͨ
+ * ͷŶռ֮ʱжռŶӣֻһйʡ
+ * һ빲ʹ棬ųռʣԭӵΪռʣڼûռʲ롣
+ * ETERFREE_LOCK_PROFILERԷͳƾ򲻲κο
+ */
 class SharedMutex
 {
 protected:
-	using Predicate = std::function<bool()>;
+	static constexpr std::size_t EXCLUSIVE = ~(SIZE_MAX >> 1);
+	static constexpr std::size_t UPGRADE = EXCLUSIVE >> 1;
+	static constexpr std::size_t SHARED_MASK = UPGRADE - 1;
+
+	// ޣԤһλ⹲־
+	static constexpr std::size_t SHARED_MAX = SIZE_MAX >> 3;
+
+protected:
+	// ȴУԭӵȴԼԪ֪ͨڳʱȴ߲֧ԭӵȴĳ
+	struct Queue
+	{
+		std::atomic<std::size_t> _waiters;
+		std::atomic<std::size_t> _sleepers;
+#ifdef ETERFREE_ATOMIC_WAIT
+		std::atomic<std::uint32_t> _epoch;
+#endif
+		std::condition_variable _condition;
+
+#ifdef ETERFREE_ATOMIC_WAIT
+		Queue() : _waiters(0), _sleepers(0), _epoch(0) {}
+#else
+		Queue() : _waiters(0), _sleepers(0) {}
+#endif
+	};
 
 protected:
+	std::atomic<std::size_t> _state;
+
 	std::mutex _mutex;
-	std::condition_variable _singleQueue;
-	std::condition_variable _batchQueue;
-	std::size_t _counter;
-	bool _flag;
+	Queue _singleQueue; // ȴʽĶռ
+	Queue _batchQueue; // 
+	Queue _writerQueue; // ռ
+
+	AdaptiveSpin _spin;
+
+#ifdef ETERFREE_LOCK_PROFILER
+	LockProfiler _profiler;
+#endif
+
+protected:
+	// ޶ռʣҲ
+	static constexpr bool exclusive(std::size_t _state) noexcept
+	{
+		return (_state & (EXCLUSIVE | UPGRADE)) == 0;
+	}
+
+	static constexpr bool unshared(std::size_t _state) noexcept
+	{
+		return (_state & SHARED_MASK) == 0;
+	}
 
-	Predicate _exclusive;
-	Predicate _unshared;
-	Predicate _shareable;
+	static constexpr bool shareable(std::size_t _state) noexcept
+	{
+		return (_state & EXCLUSIVE) == 0 \
+			&& (_state & SHARED_MASK) < SHARED_MAX;
+	}
 
 protected:
 	NODISCARD bool tryLock() noexcept;
 
 	NODISCARD bool tryLockShared() noexcept;
 
+	NODISCARD bool tryLockUpgrade() noexcept;
+
+	// ȴ޶ռʣҲʣָ־
+	void acquire(std::size_t _flag);
+
+	// ֱ״̬νʻľ
+	template <typename _Predicate>
+	NODISCARD bool spin(_Predicate _predicate)
+	{
+		return _spin.spin([this, &_predicate]
+			{
+				return _predicate(_state.load(std::memory_order_acquire));
+			});
+	}
+
+	// ֱ״̬ν
+	template <typename _Predicate>
+	void wait(Queue& _queue, _Predicate _predicate);
+
+	// ֱ״̬νʻ߳ʱʱֻʵ
+	template <typename _Clock, typename _Duration, typename _Predicate>
+	NODISCARD bool waitUntil(Queue& _queue, \
+		const std::chrono::time_point<_Clock, _Duration>& _timePoint, \
+		_Predicate _predicate);
+
+	// Ѷеһ̣߳˵ȴֱӷ
+	void notify(Queue& _queue, bool _all);
+
+	// ͷŶռʻ֮жռŶֻһй
+	void handoff();
+
+	// ĹʻѵȴĶռ
+	void release() noexcept;
+
 public:
-	SharedMutex();
+	// ָޣΪ
+	explicit SharedMutex(std::size_t _spin = ETERFREE_SPIN_ROUNDS) : \
+		_state(0), _spin(_spin) {}
 
 	SharedMutex(const SharedMutex&) = delete;
 
@@ -70,147 +161,195 @@ public:
 
 	SharedMutex& operator=(const SharedMutex&) = delete;
 
-	void lock();
-
-	NODISCARD bool try_lock()
+	NODISCARD std::size_t getSpin() const noexcept
 	{
-		std::lock_guard<std::mutex> lock(_mutex);
-		return tryLock();
+		return _spin.getLimit();
 	}
 
-	void unlock();
-
-	void lock_shared();
-
-	NODISCARD bool try_lock_shared()
+	void setSpin(std::size_t _spin) noexcept
 	{
-		std::lock_guard<std::mutex> lock(_mutex);
-		return tryLockShared();
+		this->_spin.setLimit(_spin);
 	}
 
-	void unlock_shared();
-};
+#ifdef ETERFREE_LOCK_PROFILER
+	NODISCARD LockProfiler& getProfiler() noexcept
+	{
+		return _profiler;
+	}
 #endif
 
-#ifdef ETERFREE_SHARED_TIMED_MUTEX
-class SharedTimedMutex final : public SharedMutex
-{
-	template <typename _Rep, typename _Period>
-	static NODISCARD auto getDuration(const std::chrono::steady_clock::time_point& _timePoint, \
-		const std::chrono::duration<_Rep, _Period>& _duration) -> std::chrono::nanoseconds;
+	void lock();
 
-public:
-	SharedTimedMutex() = default;
+	NODISCARD bool try_lock() noexcept;
 
-	SharedTimedMutex(const SharedTimedMutex&) = delete;
+	void unlock();
 
-	SharedTimedMutex& operator=(const SharedTimedMutex&) = delete;
+	void lock_shared();
 
-	template <typename _Rep, typename _Period>
-	NODISCARD bool try_lock_for(const std::chrono::duration<_Rep, _Period>& _duration);
+	NODISCARD bool try_lock_shared() noexcept;
 
-	template <typename _Clock, typename _Duration>
-	NODISCARD bool try_lock_until(const std::chrono::time_point<_Clock, _Duration>& _timePoint);
+	void unlock_shared();
 
-	template <typename _Rep, typename _Period>
-	NODISCARD bool try_lock_shared_for(const std::chrono::duration<_Rep, _Period>& _duration);
+	void lock_upgrade();
 
-	template <typename _Clock, typename _Duration>
-	NODISCARD bool try_lock_shared_until(const std::chrono::time_point<_Clock, _Duration>& _timePoint);
+	NODISCARD bool try_lock_upgrade() noexcept;
+
+	void unlock_upgrade();
+
+	// ԭӵתΪռʣʣȴйʽ
+	void unlock_upgrade_and_lock();
+
+	// ԭӵתΪ
+	void unlock_upgrade_and_lock_shared();
 };
 
-template <typename _Rep, typename _Period>
-auto SharedTimedMutex::getDuration(const std::chrono::steady_clock::time_point& _timePoint, \
-	const std::chrono::duration<_Rep, _Period>& _duration) -> std::chrono::nanoseconds
+template <typename _Predicate>
+void SharedMutex::wait(Queue& _queue, _Predicate _predicate)
 {
-	using namespace std::chrono;
+	if (spin(_predicate)) return;
+
+	// ӵȴټ״̬֪ͨߵ˳෴ȷһ۲쵽һ
+	_queue._waiters.fetch_add(1);
 
-	auto duration = steady_clock::now() - _timePoint;
+#ifdef ETERFREE_ATOMIC_WAIT
+	while (true)
+	{
+		auto epoch = _queue._epoch.load();
+		if (_predicate(_state.load())) break;
 
-	using Duration = decltype(duration);
+		_queue._epoch.wait(epoch);
+	}
+
+#else
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_queue._sleepers.fetch_add(1);
+		_queue._condition.wait(lock, [this, &_predicate]
+			{
+				return _predicate(_state.load());
+			});
+		_queue._sleepers.fetch_sub(1);
+	}
+#endif
 
-	duration = _duration > duration ? _duration - duration : Duration::zero();
-	return duration_cast<nanoseconds>(duration);
+	_queue._waiters.fetch_sub(1);
 }
 
-template <typename _Rep, typename _Period>
-bool SharedTimedMutex::try_lock_for(const std::chrono::duration<_Rep, _Period>& _duration)
+template <typename _Clock, typename _Duration, typename _Predicate>
+bool SharedMutex::waitUntil(Queue& _queue, \
+	const std::chrono::time_point<_Clock, _Duration>& _timePoint, \
+	_Predicate _predicate)
 {
-	using namespace std::chrono;
+	if (spin(_predicate)) return true;
+
+	_queue._waiters.fetch_add(1);
 
 	std::unique_lock<std::mutex> lock(_mutex);
+	_queue._sleepers.fetch_add(1);
+	auto result = _queue._condition.wait_until(lock, _timePoint, [this, &_predicate]
+		{
+			return _predicate(_state.load());
+		});
+	_queue._sleepers.fetch_sub(1);
+	lock.unlock();
+
+	_queue._waiters.fetch_sub(1);
+	return result;
+}
 
-	auto timePoint = steady_clock::now();
-	auto duration = getDuration(timePoint, _duration);
+class SharedTimedMutex final : public SharedMutex
+{
+private:
+	// ռ·ʱ򷵻false
+	template <typename _Clock, typename _Duration>
+	NODISCARD bool lockUntil(const std::chrono::time_point<_Clock, _Duration>& _timePoint);
 
-	using Duration = decltype(duration);
+public:
+	explicit SharedTimedMutex(std::size_t _spin = ETERFREE_SPIN_ROUNDS) : \
+		SharedMutex(_spin) {}
 
-	if (duration == Duration::zero()) return tryLock();
+	SharedTimedMutex(const SharedTimedMutex&) = delete;
 
-	if (!_batchQueue.wait_for(lock, duration, _exclusive)) return false;
+	SharedTimedMutex& operator=(const SharedTimedMutex&) = delete;
 
-	auto flag = _flag = true;
+	template <typename _Rep, typename _Period>
+	NODISCARD bool try_lock_for(const std::chrono::duration<_Rep, _Period>& _duration)
+	{
+		return try_lock_until(std::chrono::steady_clock::now() + _duration);
+	}
 
-	timePoint = steady_clock::now();
-	duration = getDuration(timePoint, _duration);
-	if (duration == Duration::zero())
-		if (flag = _unshared()) return true;
+	template <typename _Clock, typename _Duration>
+	NODISCARD bool try_lock_until(const std::chrono::time_point<_Clock, _Duration>& _timePoint);
 
-	if (!flag || !_singleQueue.wait_for(lock, duration, _unshared))
+	template <typename _Rep, typename _Period>
+	NODISCARD bool try_lock_shared_for(const std::chrono::duration<_Rep, _Period>& _duration)
 	{
-		_flag = false;
-		lock.unlock();
-
-		_batchQueue.notify_all();
-		return false;
+		return try_lock_shared_until(std::chrono::steady_clock::now() + _duration);
 	}
-	return true;
-}
+
+	template <typename _Clock, typename _Duration>
+	NODISCARD bool try_lock_shared_until(const std::chrono::time_point<_Clock, _Duration>& _timePoint);
+};
 
 template <typename _Clock, typename _Duration>
-bool SharedTimedMutex::try_lock_until(const std::chrono::time_point<_Clock, _Duration>& _timePoint)
+bool SharedTimedMutex::lockUntil(const std::chrono::time_point<_Clock, _Duration>& _timePoint)
 {
-	std::unique_lock<std::mutex> lock(_mutex);
-	if (!_batchQueue.wait_until(lock, _timePoint, _exclusive)) return false;
-
-	_flag = true;
-
-	if (!_singleQueue.wait_until(lock, _timePoint, _unshared))
+	// öռ־
+	auto state = _state.load(std::memory_order_relaxed);
+	while (true)
 	{
-		_flag = false;
-		lock.unlock();
+		if (!exclusive(state))
+		{
+			// ʱ֮ʱǡñѣת߳
+			if (!waitUntil(_writerQueue, _timePoint, exclusive))
+			{
+				if (exclusive(_state.load())) handoff();
+				return false;
+			}
+
+			state = _state.load(std::memory_order_relaxed);
+			continue;
+		}
+
+		if (_state.compare_exchange_weak(state, state | EXCLUSIVE, \
+			std::memory_order_acquire, std::memory_order_relaxed))
+			break;
+	}
 
-		_batchQueue.notify_all();
+	// ȴʽʱռ־Ĺ
+	if (!waitUntil(_singleQueue, _timePoint, unshared))
+	{
+		_state.fetch_and(~EXCLUSIVE);
+		handoff();
 		return false;
 	}
 	return true;
 }
 
-template <typename _Rep, typename _Period>
-bool SharedTimedMutex::try_lock_shared_for(const std::chrono::duration<_Rep, _Period>& _duration)
+template <typename _Clock, typename _Duration>
+bool SharedTimedMutex::try_lock_until(const std::chrono::time_point<_Clock, _Duration>& _timePoint)
 {
-	std::unique_lock<std::mutex> lock(_mutex);
-
-	auto timePoint = std::chrono::steady_clock::now();
-	auto duration = getDuration(timePoint, _duration);
-
-	using Duration = decltype(duration);
-
-	if (duration == Duration::zero()) return tryLockShared();
-
-	if (!_batchQueue.wait_for(lock, duration, _shareable)) return false;
+	ETERFREE_PROFILE_BEGIN(time);
+	bool contended = !tryLock();
+	if (contended && !lockUntil(_timePoint))
+		return false;
 
-	++_counter;
+	ETERFREE_PROFILE_ACQUIRE(_profiler, EXCLUSIVE, time, contended);
 	return true;
 }
 
 template <typename _Clock, typename _Duration>
 bool SharedTimedMutex::try_lock_shared_until(const std::chrono::time_point<_Clock, _Duration>& _timePoint)
 {
-	std::unique_lock<std::mutex> lock(_mutex);
-	if (!_batchQueue.wait_until(lock, _timePoint, _shareable)) return false;
+	ETERFREE_PROFILE_BEGIN(time);
+	bool contended = false;
+	while (!tryLockShared())
+	{
+		contended = true;
+		if (!waitUntil(_batchQueue, _timePoint, shareable))
+			return false;
+	}
 
-	++_counter;
+	ETERFREE_PROFILE_ACQUIRE(_profiler, SHARED, time, contended);
 	return true;
 }
-#endif
@@ -1,19 +1,20 @@
 #pragma once
 
 #include "Version.hpp"
+#include "Common.hpp"
 
 #if CXX_VERSION < CXX_2017
-#include "Common.hpp"
 #include "SharedMutex.hpp"
 #endif
 
-#if CXX_VERSION < CXX_2014
 #include <exception>
 #include <system_error>
 #include <utility>
-#include <chrono>
 #include <mutex>
 
+#if CXX_VERSION < CXX_2014
+#include <chrono>
+
 #else
 #if CXX_VERSION >= CXX_2020
 #include <version>
@@ -70,6 +71,31 @@ namespace std
 			_mutex.unlock_shared();
 		}
 
+		void lock_upgrade()
+		{
+			_mutex.lock_upgrade();
+		}
+
+		NODISCARD bool try_lock_upgrade()
+		{
+			return _mutex.try_lock_upgrade();
+		}
+
+		void unlock_upgrade()
+		{
+			_mutex.unlock_upgrade();
+		}
+
+		void unlock_upgrade_and_lock()
+		{
+			_mutex.unlock_upgrade_and_lock();
+		}
+
+		void unlock_upgrade_and_lock_shared()
+		{
+			_mutex.unlock_upgrade_and_lock_shared();
+		}
+
 		NODISCARD native_handle_type native_handle() noexcept
 		{
 			return &_mutex;
@@ -142,6 +168,31 @@ namespace std
 		{
 			_mutex.unlock_shared();
 		}
+
+		void lock_upgrade()
+		{
+			_mutex.lock_upgrade();
+		}
+
+		NODISCARD bool try_lock_upgrade()
+		{
+			return _mutex.try_lock_upgrade();
+		}
+
+		void unlock_upgrade()
+		{
+			_mutex.unlock_upgrade();
+		}
+
+		void unlock_upgrade_and_lock()
+		{
+			_mutex.unlock_upgrade_and_lock();
+		}
+
+		void unlock_upgrade_and_lock_shared()
+		{
+			_mutex.unlock_upgrade_and_lock_shared();
+		}
 	};
 #endif
 
@@ -245,11 +296,10 @@ namespace std
 
 		void unlock();
 
-		template <typename _mutex_type>
-		void swap(shared_lock<_mutex_type>& _lock) noexcept
+		void swap(shared_lock& _lock) noexcept
 		{
-			swap(this->_mutex, _lock._mutex);
-			swap(this->_locked, _lock._locked);
+			std::swap(this->_mutex, _lock._mutex);
+			std::swap(this->_locked, _lock._locked);
 		}
 
 		mutex_type* release() noexcept;
@@ -341,3 +391,203 @@ namespace std
 	}
 #endif
 }
+
+ETERFREE_SPACE_BEGIN
+
+template <typename _mutex_type>
+class upgrade_lock
+{
+public:
+	using mutex_type = _mutex_type;
+
+private:
+	mutex_type* _mutex;
+	bool _locked;
+
+private:
+	static void throw_system_error(std::errc _errc)
+	{
+		throw std::system_error{ std::make_error_code(_errc) };
+	}
+
+private:
+	void validate() const;
+
+	void try_unlock() noexcept;
+
+	void verify() const
+	{
+		if (!_locked || _mutex == nullptr)
+			throw_system_error(std::errc::operation_not_permitted);
+	}
+
+public:
+	upgrade_lock() noexcept : \
+		_mutex(nullptr), _locked(false) {}
+
+	upgrade_lock(const upgrade_lock&) = delete;
+
+	upgrade_lock(upgrade_lock&& _another) noexcept : \
+		_mutex(_another._mutex), _locked(_another._locked)
+	{
+		_another._mutex = nullptr;
+		_another._locked = false;
+	}
+
+	explicit upgrade_lock(mutex_type& _mutex) : \
+		_mutex(&_mutex), _locked(true)
+	{
+		_mutex.lock_upgrade();
+	}
+
+	upgrade_lock(mutex_type& _mutex, std::defer_lock_t) noexcept : \
+		_mutex(&_mutex), _locked(false) {}
+
+	upgrade_lock(mutex_type& _mutex, std::try_to_lock_t) : \
+		_mutex(&_mutex), _locked(_mutex.try_lock_upgrade()) {}
+
+	upgrade_lock(mutex_type& _mutex, std::adopt_lock_t) noexcept : \
+		_mutex(&_mutex), _locked(true) {}
+
+	~upgrade_lock()
+	{
+		try_unlock();
+	}
+
+	upgrade_lock& operator=(const upgrade_lock&) = delete;
+
+	upgrade_lock& operator=(upgrade_lock&& _lock) noexcept;
+
+	explicit operator bool() const noexcept
+	{
+		return _locked;
+	}
+
+	void lock();
+
+	NODISCARD bool try_lock()
+	{
+		validate();
+		return _locked = _mutex->try_lock_upgrade();
+	}
+
+	void unlock();
+
+	NODISCARD std::unique_lock<mutex_type> upgrade();
+
+	NODISCARD std::shared_lock<mutex_type> downgrade();
+
+	void swap(upgrade_lock& _lock) noexcept
+	{
+		std::swap(this->_mutex, _lock._mutex);
+		std::swap(this->_locked, _lock._locked);
+	}
+
+	mutex_type* release() noexcept;
+
+	NODISCARD mutex_type* mutex() const noexcept
+	{
+		return _mutex;
+	}
+
+	NODISCARD bool owns_lock() const noexcept
+	{
+		return _locked;
+	}
+};
+
+template <typename _mutex_type>
+void upgrade_lock<_mutex_type>::validate() const
+{
+	if (_mutex == nullptr)
+		throw_system_error(std::errc::operation_not_permitted);
+
+	if (_locked)
+		throw_system_error(std::errc::resource_deadlock_would_occur);
+}
+
+template <typename _mutex_type>
+void upgrade_lock<_mutex_type>::try_unlock() noexcept
+{
+	if (!_locked || _mutex == nullptr) return;
+
+	try
+	{
+		_mutex->unlock_upgrade();
+		_locked = false;
+	}
+	catch (std::exception&) {}
+}
+
+template <typename _mutex_type>
+auto upgrade_lock<_mutex_type>::operator=(upgrade_lock&& _lock) noexcept \
+	-> upgrade_lock&
+{
+	if (&_lock != this)
+	{
+		try_unlock();
+
+		this->_mutex = _lock._mutex;
+		this->_locked = _lock._locked;
+		_lock._mutex = nullptr;
+		_lock._locked = false;
+	}
+	return *this;
+}
+
+template <typename _mutex_type>
+void upgrade_lock<_mutex_type>::lock()
+{
+	validate();
+
+	_mutex->lock_upgrade();
+	_locked = true;
+}
+
+template <typename _mutex_type>
+void upgrade_lock<_mutex_type>::unlock()
+{
+	verify();
+
+	_mutex->unlock_upgrade();
+	_locked = false;
+}
+
+template <typename _mutex_type>
+auto upgrade_lock<_mutex_type>::upgrade() \
+	-> std::unique_lock<mutex_type>
+{
+	verify();
+
+	_mutex->unlock_upgrade_and_lock();
+	return std::unique_lock<mutex_type>(*release(), std::adopt_lock);
+}
+
+template <typename _mutex_type>
+auto upgrade_lock<_mutex_type>::downgrade() \
+	-> std::shared_lock<mutex_type>
+{
+	verify();
+
+	_mutex->unlock_upgrade_and_lock_shared();
+	return std::shared_lock<mutex_type>(*release(), std::adopt_lock);
+}
+
+template <typename _mutex_type>
+auto upgrade_lock<_mutex_type>::release() noexcept \
+	-> mutex_type*
+{
+	auto mutex = _mutex;
+	_mutex = nullptr;
+	_locked = false;
+	return mutex;
+}
+
+template <typename _mutex_type>
+void swap(upgrade_lock<_mutex_type>& left, \
+	upgrade_lock<_mutex_type>& right) noexcept
+{
+	left.swap(right);
+}
+
+ETERFREE_SPACE_END